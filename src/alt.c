@@ -0,0 +1,295 @@
+#include "alt.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <float.h>
+#include <math.h>
+#include <stdint.h>
+
+// ============================================================================
+// ALT - A* COM LANDMARKS
+// ============================================================================
+// As tabelas ficam por nó: ida[v*k + i] = d(L_i, v) e volta[v*k + i] =
+// d(v, L_i). Assim h(v) lê k valores contíguos de cada tabela.
+// DBL_MAX marca pares inalcançáveis.
+// ============================================================================
+
+typedef struct {
+    Graph g;
+    int n, k;
+    int crit;
+    CalculaCustoAresta f;
+    unsigned long versao;
+    Node* marcos;
+    double* ida;
+    double* volta;
+} LandmarksImpl;
+
+static const char MAGICO[4] = { 'A', 'L', 'T', '1' };
+
+// Limite inferior de d(v, t) pelos `k` primeiros landmarks.
+// Um termo sem as duas distâncias finitas não limita nada e é ignorado, com
+// uma exceção: se L alcança v mas não t (ou t alcança L mas v não), v não
+// alcança t e o limite é infinito.
+static double limite(LandmarksImpl* L, int k, Node v, Node t) {
+    if (v >= L->n || t >= L->n) return 0;  // Nó novo: sem informação
+    const double* iv = L->ida + (size_t)v * L->k;
+    const double* it = L->ida + (size_t)t * L->k;
+    const double* vv = L->volta + (size_t)v * L->k;
+    const double* vt = L->volta + (size_t)t * L->k;
+    double h = 0;
+    for (int i = 0; i < k; i++) {
+        if (it[i] != DBL_MAX) {
+            if (iv[i] != DBL_MAX) { if (it[i] - iv[i] > h) h = it[i] - iv[i]; }
+        } else if (iv[i] != DBL_MAX) return INFINITY;
+        if (vv[i] != DBL_MAX) {
+            if (vt[i] != DBL_MAX) { if (vv[i] - vt[i] > h) h = vv[i] - vt[i]; }
+        } else if (vt[i] != DBL_MAX) return INFINITY;
+    }
+    return h;
+}
+
+static double heuristicaALT(Node v, Node end, void* ctx) {
+    LandmarksImpl* L = (LandmarksImpl*)ctx;
+    return limite(L, L->k, v, end);
+}
+
+static LandmarksImpl* novoLandmarks(Graph g, int n, int k, int crit, CalculaCustoAresta f) {
+    LandmarksImpl* L = calloc(1, sizeof(LandmarksImpl));
+    L->g = g;
+    L->n = n;
+    L->crit = crit;
+    L->f = f;
+    L->versao = getGraphVersion(g);
+    L->marcos = malloc((k > 0 ? k : 1) * sizeof(Node));
+    L->ida = malloc(((size_t)n * k > 0 ? (size_t)n * k : 1) * sizeof(double));
+    L->volta = malloc(((size_t)n * k > 0 ? (size_t)n * k : 1) * sizeof(double));
+    return L;
+}
+
+// ----------------------------------------------------------------------------
+// Escolha dos landmarks
+// ----------------------------------------------------------------------------
+// Nó alcançado mais distante de `origem` (a própria origem se for isolada)
+static Node maisDistante(const double* dist, int n, Node origem) {
+    Node melhor = origem;
+    for (int v = 0; v < n; v++)
+        if (dist[v] != DBL_MAX && dist[v] > dist[melhor]) melhor = v;
+    return melhor;
+}
+
+// Farthest: maximiza a menor distância até os landmarks já escolhidos. Em
+// grafo dirigido vale o sentido mais curto (ida ou volta): um landmark sem
+// saídas ainda mede a distância pelas entradas.
+static Node proximoFarthest(LandmarksImpl* L, int k, const bool* usado) {
+    Node melhor = -1;
+    double melhorD = -1;
+    for (int v = 0; v < L->n; v++) {
+        if (usado[v]) continue;
+        double d = DBL_MAX;
+        const double* iv = L->ida + (size_t)v * L->k;
+        const double* vv = L->volta + (size_t)v * L->k;
+        for (int i = 0; i < k; i++) {
+            if (iv[i] < d) d = iv[i];
+            if (vv[i] < d) d = vv[i];
+        }
+        if (d != DBL_MAX && d > melhorD) { melhorD = d; melhor = v; }
+    }
+    return melhor;
+}
+
+typedef struct { double d; int id; } DistNo;
+
+static int comparaDistDecrescente(const void* a, const void* b) {
+    double da = ((const DistNo*)a)->d, db = ((const DistNo*)b)->d;
+    return (da < db) - (da > db);
+}
+
+// xorshift64: sorteio local e determinístico (não mexe no rand() global, e o
+// mesmo grafo sempre gera os mesmos landmarks)
+static uint64_t sorteia(uint64_t* estado) {
+    uint64_t x = *estado;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return *estado = x;
+}
+
+// Avoid (Goldberg & Werneck): árvore de caminhos mínimos a partir de uma raiz
+// r sorteada; peso(v) = d(r, v) - limite(r, v) mede o quanto os landmarks atuais erram.
+// tam(v) soma os pesos da subárvore, ou 0 se ela já contém um landmark.
+// Desce da raiz pelo filho de maior tam até uma folha: ela vira landmark.
+static Node proximoAvoid(LandmarksImpl* L, int k, const bool* usado, double* dist, Node* pai,
+                         uint64_t* estado) {
+    int n = L->n;
+    Node r = (Node)(sorteia(estado) % (uint64_t)n);
+    shortestDistances(L->g, r, L->crit, L->f, false, dist, pai);
+    
+    double* tam = malloc(n * sizeof(double));
+    bool* temMarco = calloc(n, sizeof(bool));
+    DistNo* chaves = malloc(n * sizeof(DistNo));
+    int cnt = 0;
+    for (int v = 0; v < n; v++) {
+        if (dist[v] == DBL_MAX) continue;
+        tam[v] = dist[v] - limite(L, k, r, v);
+        temMarco[v] = usado[v];
+        chaves[cnt++] = (DistNo){ dist[v], v };
+    }
+    // Folhas primeiro: cada nó repassa o tamanho ao pai
+    qsort(chaves, cnt, sizeof(DistNo), comparaDistDecrescente);
+    int* ordem = malloc((cnt > 0 ? cnt : 1) * sizeof(int));
+    for (int i = 0; i < cnt; i++) ordem[i] = chaves[i].id;
+    free(chaves);
+    for (int i = 0; i < cnt; i++) {
+        int v = ordem[i];
+        if (pai[v] == -1) continue;
+        if (temMarco[v]) temMarco[pai[v]] = true;
+        else tam[pai[v]] += tam[v];
+    }
+    for (int i = 0; i < cnt; i++) if (temMarco[ordem[i]]) tam[ordem[i]] = 0;
+    
+    // Filhos em CSR para a descida
+    int* off = calloc(n + 1, sizeof(int));
+    int* filho = malloc((cnt > 0 ? cnt : 1) * sizeof(int));
+    for (int i = 0; i < cnt; i++) if (pai[ordem[i]] != -1) off[pai[ordem[i]] + 1]++;
+    for (int v = 0; v < n; v++) off[v+1] += off[v];
+    int* prox = malloc(n * sizeof(int));
+    memcpy(prox, off, n * sizeof(int));
+    for (int i = 0; i < cnt; i++) if (pai[ordem[i]] != -1) filho[prox[pai[ordem[i]]]++] = ordem[i];
+    
+    Node v = r, escolhido = -1;
+    if (!temMarco[r] || tam[r] > 0) {
+        while (true) {
+            Node melhor = -1;
+            for (int i = off[v]; i < off[v+1]; i++)
+                if (tam[filho[i]] > 0 && (melhor == -1 || tam[filho[i]] > tam[melhor])) melhor = filho[i];
+            if (melhor == -1) break;
+            v = melhor;
+        }
+        if (!usado[v]) escolhido = v;
+    }
+    free(tam); free(temMarco); free(ordem); free(off); free(filho); free(prox);
+    // Árvore sem região descoberta: recorre ao critério farthest
+    return escolhido != -1 ? escolhido : proximoFarthest(L, k, usado);
+}
+
+static void calculaTabelas(LandmarksImpl* L, int i, double* dist) {
+    int n = L->n;
+    shortestDistances(L->g, L->marcos[i], L->crit, L->f, false, dist, NULL);
+    for (int v = 0; v < n; v++) L->ida[(size_t)v * L->k + i] = dist[v];
+    shortestDistances(L->g, L->marcos[i], L->crit, L->f, true, dist, NULL);
+    for (int v = 0; v < n; v++) L->volta[(size_t)v * L->k + i] = dist[v];
+}
+
+Landmarks createLandmarks(Graph g, int k, int estrategia, int crit, CalculaCustoAresta f) {
+    int n = getTotalNodes(g);
+    if (k > n) k = n;
+    if (k < 0) k = 0;
+    LandmarksImpl* L = novoLandmarks(g, n, k, crit, f);
+    L->k = k;  // Largura das linhas; landmarks escolhidos vão de 0 a `num`
+    if (k == 0) return L;
+    
+    double* dist = malloc(n * sizeof(double));
+    Node* pai = malloc(n * sizeof(Node));
+    bool* usado = calloc(n, sizeof(bool));
+    
+    // Primeiro landmark: o nó mais distante do nó 0
+    shortestDistances(g, 0, crit, f, false, dist, NULL);
+    int num = 0;
+    Node v = maisDistante(dist, n, 0);
+    // Semente do Avoid tirada do grafo (nunca 0, ponto fixo do xorshift)
+    uint64_t estado = ((uint64_t)n << 32 | (uint32_t)(v + 1)) * 0x9E3779B97F4A7C15ULL | 1;
+    while (num < k && v != -1) {
+        L->marcos[num] = v;
+        usado[v] = true;
+        calculaTabelas(L, num, dist);
+        num++;
+        if (num == k) break;
+        v = (estrategia == LANDMARKS_AVOID) ? proximoAvoid(L, num, usado, dist, pai, &estado)
+                                            : proximoFarthest(L, num, usado);
+    }
+    free(dist);
+    free(pai);
+    free(usado);
+    
+    if (num < k) {
+        // Menos candidatos que o pedido: compacta as linhas para largura `num`
+        for (int u = 0; u < n; u++)
+            for (int i = 0; i < num; i++) {
+                L->ida[(size_t)u * num + i] = L->ida[(size_t)u * k + i];
+                L->volta[(size_t)u * num + i] = L->volta[(size_t)u * k + i];
+            }
+        L->k = num;
+    }
+    return L;
+}
+
+// ----------------------------------------------------------------------------
+// Consulta
+// ----------------------------------------------------------------------------
+Lista alt_findPath(Landmarks lm, Node start, Node end) {
+    LandmarksImpl* L = (LandmarksImpl*)lm;
+    return findPathAStar(L->g, start, end, L->crit, L->f, heuristicaALT, L);
+}
+
+double alt_lowerBound(Landmarks lm, Node v, Node end) {
+    LandmarksImpl* L = (LandmarksImpl*)lm;
+    return limite(L, L->k, v, end);
+}
+
+int alt_numLandmarks(Landmarks lm) { return ((LandmarksImpl*)lm)->k; }
+Node alt_getLandmark(Landmarks lm, int i) { return ((LandmarksImpl*)lm)->marcos[i]; }
+
+bool alt_isStale(Landmarks lm) {
+    LandmarksImpl* L = (LandmarksImpl*)lm;
+    return L->versao != getGraphVersion(L->g);
+}
+
+// ----------------------------------------------------------------------------
+// Serialização: "ALT1", n, k, crit, marcos[k], ida[n*k], volta[n*k]
+// ----------------------------------------------------------------------------
+bool alt_save(Landmarks lm, const char* arquivo) {
+    LandmarksImpl* L = (LandmarksImpl*)lm;
+    FILE* fp = fopen(arquivo, "wb");
+    if (!fp) return false;
+    size_t nk = (size_t)L->n * L->k;
+    int cab[3] = { L->n, L->k, L->crit };
+    bool ok = fwrite(MAGICO, 1, 4, fp) == 4 &&
+              fwrite(cab, sizeof(int), 3, fp) == 3 &&
+              fwrite(L->marcos, sizeof(Node), L->k, fp) == (size_t)L->k &&
+              fwrite(L->ida, sizeof(double), nk, fp) == nk &&
+              fwrite(L->volta, sizeof(double), nk, fp) == nk;
+    if (fclose(fp) != 0) ok = false;
+    return ok;
+}
+
+Landmarks alt_load(Graph g, const char* arquivo, int crit, CalculaCustoAresta f) {
+    FILE* fp = fopen(arquivo, "rb");
+    if (!fp) return NULL;
+    char magico[4];
+    int cab[3];
+    if (fread(magico, 1, 4, fp) != 4 || memcmp(magico, MAGICO, 4) != 0 ||
+        fread(cab, sizeof(int), 3, fp) != 3 ||
+        cab[0] != getTotalNodes(g) || cab[1] < 0 || cab[1] > cab[0] || cab[2] != crit) {
+        fclose(fp);
+        return NULL;
+    }
+    LandmarksImpl* L = novoLandmarks(g, cab[0], cab[1], crit, f);
+    L->k = cab[1];
+    size_t nk = (size_t)L->n * L->k;
+    bool ok = fread(L->marcos, sizeof(Node), L->k, fp) == (size_t)L->k &&
+              fread(L->ida, sizeof(double), nk, fp) == nk &&
+              fread(L->volta, sizeof(double), nk, fp) == nk;
+    fclose(fp);
+    for (int i = 0; ok && i < L->k; i++) if (L->marcos[i] < 0 || L->marcos[i] >= L->n) ok = false;
+    if (!ok) { alt_destroy(L); return NULL; }
+    return L;
+}
+
+void alt_destroy(Landmarks lm) {
+    LandmarksImpl* L = (LandmarksImpl*)lm;
+    free(L->marcos);
+    free(L->ida);
+    free(L->volta);
+    free(L);
+}
@@ -0,0 +1,36 @@
+#ifndef ALT_H
+#define ALT_H
+#include "graph.h"
+
+// ALT (A*, Landmarks, desigualdade Triangular): para k nós "landmark" L
+// guarda d(L, v) e d(v, L) de todos os nós v. Pela desigualdade triangular,
+//   d(v, t) >= d(L, t) - d(L, v)   e   d(v, t) >= d(v, L) - d(t, L),
+// o que dá ao A* um limite inferior bem mais justo que a linha reta.
+// O pré-processamento é só 2k buscas de um para todos, bem mais barato que
+// Contraction Hierarchies.
+typedef void* Landmarks;
+
+#define LANDMARKS_FARTHEST 0  // Cada novo landmark é o nó mais longe dos já escolhidos
+#define LANDMARKS_AVOID 1     // "Avoid" (Goldberg-Werneck): cobre as regiões de pior limite
+
+Landmarks createLandmarks(Graph g, int k, int estrategia, int crit, CalculaCustoAresta f);
+// Escolhe até `k` landmarks e calcula suas tabelas de distância com os pesos
+// de `f` no critério `crit`.
+Lista alt_findPath(Landmarks lm, Node start, Node end);
+// Caminho mínimo start -> end com A* guiado pelos landmarks.
+double alt_lowerBound(Landmarks lm, Node v, Node end);
+// Limite inferior do custo v -> end (0 para nós criados após as tabelas).
+int alt_numLandmarks(Landmarks lm);
+Node alt_getLandmark(Landmarks lm, int i);
+bool alt_isStale(Landmarks lm);
+// true se o grafo mudou depois das tabelas. Se os pesos só aumentaram
+// (ex.: penalidades de trânsito), os limites continuam válidos: o caminho
+// segue ótimo, apenas a busca fica menos dirigida.
+bool alt_save(Landmarks lm, const char* arquivo);
+// Grava landmarks e tabelas em arquivo binário. Retorna false se falhar.
+Landmarks alt_load(Graph g, const char* arquivo, int crit, CalculaCustoAresta f);
+// Lê tabelas gravadas por alt_save para o mesmo grafo (mesmo total de nós e
+// mesmo critério). Retorna NULL se o arquivo não existir ou não corresponder.
+void alt_destroy(Landmarks lm);
+
+#endif
@@ -0,0 +1,82 @@
+#include "arena.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Alocador de região (arena): serve muitos objetos pequenos a partir de
+// poucos blocos grandes e contíguos, e libera tudo numa única chamada.
+// Elimina o custo de um malloc por aresta/nó e a fragmentação do heap.
+#define ALINHAMENTO 16
+#define BLOCO_PADRAO (64 * 1024)
+
+typedef struct Bloco {
+    struct Bloco* prox;  // Blocos anteriores (lista para liberar no final)
+    size_t usado;
+    size_t cap;
+} Bloco;
+
+// A área útil começa logo após o cabeçalho, arredondado ao alinhamento
+#define CABECALHO ((sizeof(Bloco) + ALINHAMENTO - 1) & ~(size_t)(ALINHAMENTO - 1))
+#define DADOS(b) ((char*)(b) + CABECALHO)
+
+typedef struct {
+    Bloco* atual;
+    size_t tamBloco;
+} ArenaImpl;
+
+Arena arena_cria(size_t tamBloco) {
+    ArenaImpl* a = calloc(1, sizeof(ArenaImpl));
+    a->tamBloco = tamBloco > 0 ? tamBloco : BLOCO_PADRAO;
+    return a;
+}
+
+static Bloco* novoBloco(size_t cap, Bloco* prox) {
+    Bloco* b = malloc(CABECALHO + cap);
+    if (!b) return NULL;
+    b->prox = prox;
+    b->usado = 0;
+    b->cap = cap;
+    return b;
+}
+
+void* arena_aloca(Arena arena, size_t tam) {
+    ArenaImpl* a = (ArenaImpl*)arena;
+    tam = (tam + ALINHAMENTO - 1) & ~(size_t)(ALINHAMENTO - 1);
+    
+    Bloco* b = a->atual;
+    if (!b || b->usado + tam > b->cap) {
+        // Pedidos maiores que um bloco ganham um bloco exclusivo, que fica
+        // atrás do atual para não desperdiçar o espaço restante dele
+        if (tam > a->tamBloco && b) {
+            Bloco* grande = novoBloco(tam, b->prox);
+            if (!grande) return NULL;
+            b->prox = grande;
+            grande->usado = tam;
+            return DADOS(grande);
+        }
+        b = novoBloco(tam > a->tamBloco ? tam : a->tamBloco, a->atual);
+        if (!b) return NULL;
+        a->atual = b;
+    }
+    void* p = DADOS(b) + b->usado;
+    b->usado += tam;
+    return p;
+}
+
+char* arena_duplica_string(Arena a, const char* s) {
+    if (!s) return NULL;
+    size_t n = strlen(s) + 1;
+    char* d = arena_aloca(a, n);
+    if (d) memcpy(d, s, n);
+    return d;
+}
+
+void arena_libera(Arena arena) {
+    ArenaImpl* a = (ArenaImpl*)arena;
+    Bloco* b = a->atual;
+    while (b) {
+        Bloco* prox = b->prox;
+        free(b);
+        b = prox;
+    }
+    free(a);
+}
@@ -0,0 +1,16 @@
+#ifndef ARENA_H
+#define ARENA_H
+#include <stddef.h>
+
+typedef void* Arena;
+
+// Cria uma arena que aloca blocos de `tamBloco` bytes (<= 0 usa um padrão).
+Arena arena_cria(size_t tamBloco);
+// Reserva `tam` bytes alinhados dentro da arena. Não há free individual.
+void* arena_aloca(Arena a, size_t tam);
+// Copia `s` para dentro da arena.
+char* arena_duplica_string(Arena a, const char* s);
+// Libera todos os blocos de uma vez (invalida tudo que foi alocado).
+void arena_libera(Arena a);
+
+#endif
@@ -0,0 +1,553 @@
+#include "ch.h"
+#include "priority_queue.h"
+#include <stdlib.h>
+#include <string.h>
+#include <float.h>
+#include <stdint.h>
+
+// ============================================================================
+// CONTRACTION HIERARCHIES
+// ============================================================================
+// Pré-processamento:
+//   1. Cada nó recebe uma prioridade (ver `prioridade`) a partir de uma
+//      contração simulada.
+//   2. O nó de menor prioridade é retirado da fila e a prioridade é
+//      recalculada (atualização preguiçosa); se ainda for o menor, ele é
+//      contraído: para cada par u -> v -> w, se nenhum caminho "testemunha"
+//      u -> w sem v for tão curto quanto, insere o atalho u -> w (meio = v).
+//      Depois, as prioridades dos vizinhos de v são recalculadas.
+//   3. A ordem de contração vira o nível (rank) do nó.
+// A busca de testemunha é limitada em saltos e em nós fechados: sem achar
+// testemunha, o atalho é inserido (a hierarquia continua correta, só maior).
+// Consulta: Dijkstra bidirecional que só sobe de nível (arestas para nós de
+// rank maior), parando quando o topo das filas passa do melhor caminho (mu).
+// Os atalhos do caminho encontrado são desempacotados recursivamente pelo
+// nó do meio até restarem só arestas originais.
+// ============================================================================
+
+// Limites da busca de testemunha: nós fechados e arcos por caminho. A
+// simulação (prioridade) roda muito mais vezes que a contração, então é
+// mais curta; errar ali só piora a ordem, não a correção.
+#define FECHADOS_SIMULACAO 50
+#define SALTOS_SIMULACAO 2
+#define FECHADOS_CONTRACAO 1000
+#define SALTOS_CONTRACAO 8
+
+// Pesos dos termos da prioridade (ver `prioridade`), ajustados em grades
+#define PESO_DIFERENCA 1.0
+#define PESO_VIZINHOS 0.25
+#define PESO_PROFUNDIDADE 1.0
+#define PESO_RAZAO 1.0
+
+// meio = -1: original. saltos = arestas originais que o arco representa.
+typedef struct { int to; double w; int meio; int saltos; } Arco;
+// Arcos para nós ainda não contraídos ficam em a[0, nAtivos): as buscas do
+// pré-processamento não percorrem os que levam a nós já contraídos
+typedef struct { Arco* a; int n, cap, nAtivos; } VetArcos;
+
+typedef struct {
+    int n;
+    Graph g;
+    unsigned long versao;  // getGraphVersion na construção
+    int nAtalhos;
+
+    // Grafo completo (originais + atalhos), usado para desempacotar
+    VetArcos* saida;
+    int* rank;
+
+    // Grafo de busca "para cima" em CSR:
+    // up: u -> x com rank[x] > rank[u]; dn: x <- u com rank[u] > rank[x]
+    int *upOff, *upTo; double* upW;
+    int *dnOff, *dnFrom; double* dnW;
+
+    // Área de trabalho da consulta, reiniciada só nos nós tocados
+    double* dist[2];
+    int* pai[2];
+    bool* fechado[2];
+    int* tocados;
+    int nTocados;
+    int* seq;    // Caminho no grafo com atalhos (n)
+    int* pilha;  // Desempacotamento (2n + 4)
+    priorityQueue pq[2];
+} CHImpl;
+
+// ----------------------------------------------------------------------------
+// Vetores dinâmicos de arcos
+// ----------------------------------------------------------------------------
+// Índice (u, to) -> posição do arco em vet[u], com endereçamento aberto.
+// Arcos nunca são removidos, então não há lápides.
+typedef struct {
+    uint64_t* chave;  // ((u << 32) | to) + 1; 0 = vazio
+    int* pos;
+    int cap, n;       // cap potência de 2
+} IndiceArcos;
+
+static inline unsigned baldeArco(uint64_t chave, int cap) {
+    return (unsigned)((chave * 0x9E3779B97F4A7C15ULL) >> 32) & (cap - 1);
+}
+
+static void indiceCresce(IndiceArcos* ix) {
+    int velhoCap = ix->cap;
+    uint64_t* velhaChave = ix->chave;
+    int* velhaPos = ix->pos;
+    ix->cap = velhoCap ? 2*velhoCap : 1024;
+    ix->chave = calloc(ix->cap, sizeof(uint64_t));
+    ix->pos = malloc(ix->cap * sizeof(int));
+    for (int i = 0; i < velhoCap; i++) {
+        if (!velhaChave[i]) continue;
+        unsigned b = baldeArco(velhaChave[i], ix->cap);
+        while (ix->chave[b]) b = (b + 1) & (ix->cap - 1);
+        ix->chave[b] = velhaChave[i];
+        ix->pos[b] = velhaPos[i];
+    }
+    free(velhaChave);
+    free(velhaPos);
+}
+
+// Posição de u -> to em vet[u]; se não existe, -1 e o balde livre em *balde
+static int indiceBusca(const IndiceArcos* ix, uint64_t chave, unsigned* balde) {
+    unsigned b = baldeArco(chave, ix->cap);
+    while (ix->chave[b]) {
+        if (ix->chave[b] == chave) return ix->pos[b];
+        b = (b + 1) & (ix->cap - 1);
+    }
+    *balde = b;
+    return -1;
+}
+
+static inline uint64_t chaveArco(int u, int to) {
+    return (((uint64_t)u << 32) | (uint32_t)to) + 1;
+}
+
+static void indiceAtualiza(IndiceArcos* ix, uint64_t chave, int pos) {
+    unsigned b = baldeArco(chave, ix->cap);
+    while (ix->chave[b] != chave) b = (b + 1) & (ix->cap - 1);
+    ix->pos[b] = pos;
+}
+
+// Troca os arcos i e j de vet[u] de lugar, mantendo o índice em dia
+static void trocaArcos(VetArcos* v, IndiceArcos* ix, int u, int i, int j) {
+    if (i == j) return;
+    Arco t = v->a[i]; v->a[i] = v->a[j]; v->a[j] = t;
+    indiceAtualiza(ix, chaveArco(u, v->a[i].to), i);
+    indiceAtualiza(ix, chaveArco(u, v->a[j].to), j);
+}
+
+// Move u -> to para a parte dos arcos inativos (`to` foi contraído)
+static void desativaArco(VetArcos* vet, IndiceArcos* ix, int u, int to) {
+    unsigned b = 0;
+    int i = indiceBusca(ix, chaveArco(u, to), &b);
+    VetArcos* v = &vet[u];
+    if (i < 0 || i >= v->nAtivos) return;
+    trocaArcos(v, ix, u, i, --v->nAtivos);
+}
+
+// Insere u -> to ou, se já existir, mantém o menor peso (arestas paralelas e
+// atalhos que substituem arcos mais caros). Só liga nós não contraídos.
+static bool insereArco(VetArcos* vet, IndiceArcos* ix, int u, int to, double w, int meio, int saltos) {
+    if (2*(ix->n + 1) > ix->cap) indiceCresce(ix);
+    uint64_t chave = chaveArco(u, to);
+    unsigned b = 0;
+    int i = indiceBusca(ix, chave, &b);
+    VetArcos* v = &vet[u];
+    if (i >= 0) {
+        if (w < v->a[i].w) { v->a[i].w = w; v->a[i].meio = meio; v->a[i].saltos = saltos; }
+        return false;
+    }
+    if (v->n == v->cap) {
+        v->cap = v->cap ? 2*v->cap : 4;
+        v->a = realloc(v->a, v->cap * sizeof(Arco));
+    }
+    ix->chave[b] = chave;
+    ix->pos[b] = v->n;
+    ix->n++;
+    v->a[v->n++] = (Arco){to, w, meio, saltos};
+    trocaArcos(v, ix, u, v->n - 1, v->nAtivos++);
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+// Estado do pré-processamento
+// ----------------------------------------------------------------------------
+typedef struct {
+    int n;
+    VetArcos* saida;
+    VetArcos* entrada;
+    IndiceArcos ixSaida, ixEntrada;
+    bool* contraido;
+    int* vizContraidos;  // "deleted neighbours"
+    int* prof;           // Nível de contração mais alto entre os vizinhos + 1
+    int totalArcos;
+    // Busca de testemunhas
+    double* wd;
+    int* saltos; // Arcos no caminho até cada nó tocado
+    bool* alvo;  // Saídas do nó em contração ainda não fechadas
+    int* wTocados;
+    int nwTocados;
+    priorityQueue wpq;  // Indexado: decrease-key, sem entradas velhas
+} Preproc;
+
+// Dijkstra local a partir de u no grafo restante, sem passar por `ignorado`.
+// Para ao fechar os `nAlvos` nós marcados em p->alvo, ao passar de `limite`
+// ou de `maxFechados` nós fechados; não estende caminhos com `maxSaltos`
+// arcos. Deixa as distâncias em p->wd (DBL_MAX = não alcançado).
+static void buscaTestemunha(Preproc* p, int u, int ignorado, double limite, int nAlvos,
+                            int maxFechados, int maxSaltos) {
+    p->wd[u] = 0;
+    p->saltos[u] = 0;
+    p->wTocados[p->nwTocados++] = u;
+    pq_insert(p->wpq, u, 0);
+    int fechados = 0;
+    while (!pq_empty(p->wpq)) {
+        if (pq_min_prio(p->wpq) > limite || fechados >= maxFechados) break;
+        int x = pq_extract_min(p->wpq);
+        double d = p->wd[x];
+        fechados++;
+        if (p->alvo[x] && --nAlvos == 0) break;
+        if (p->saltos[x] >= maxSaltos) continue;
+        VetArcos* s = &p->saida[x];
+        for (int i = 0; i < s->nAtivos; i++) {
+            int y = s->a[i].to;
+            if (y == ignorado) continue;
+            double nd = d + s->a[i].w;
+            if (nd < p->wd[y]) {
+                if (p->wd[y] == DBL_MAX) p->wTocados[p->nwTocados++] = y;
+                p->wd[y] = nd;
+                p->saltos[y] = p->saltos[x] + 1;
+                pq_decrease_key(p->wpq, y, nd);
+            }
+        }
+    }
+    pq_clear(p->wpq);
+}
+
+static void limpaTestemunha(Preproc* p) {
+    for (int i = 0; i < p->nwTocados; i++) p->wd[p->wTocados[i]] = DBL_MAX;
+    p->nwTocados = 0;
+}
+
+// Contrai v (ou só simula, para calcular a prioridade). Retorna o número de
+// atalhos necessários; `saltos` (se != NULL) recebe a soma dos seus saltos.
+static int contraiNo(Preproc* p, int v, bool simular, int* saltos) {
+    VetArcos* in = &p->entrada[v];
+    VetArcos* out = &p->saida[v];
+    double maxSaida = 0;
+    int nAlvos = 0;
+    for (int j = 0; j < out->nAtivos; j++) {
+        int x = out->a[j].to;
+        if (x == v) continue;
+        if (out->a[j].w > maxSaida) maxSaida = out->a[j].w;
+        p->alvo[x] = true;
+        nAlvos++;
+    }
+
+    int atalhos = 0, somaSaltos = 0;
+    for (int i = 0; i < in->nAtivos; i++) {
+        int u = in->a[i].to;
+        if (u == v) continue;
+        double w1 = in->a[i].w;
+        int s1 = in->a[i].saltos;
+        if (simular) buscaTestemunha(p, u, v, w1 + maxSaida, nAlvos, FECHADOS_SIMULACAO, SALTOS_SIMULACAO);
+        else buscaTestemunha(p, u, v, w1 + maxSaida, nAlvos, FECHADOS_CONTRACAO, SALTOS_CONTRACAO);
+        for (int j = 0; j < out->nAtivos; j++) {
+            int x = out->a[j].to;
+            if (x == u || x == v) continue;
+            double w = w1 + out->a[j].w;
+            if (p->wd[x] <= w) continue;  // Existe testemunha
+            int s = s1 + out->a[j].saltos;
+            atalhos++;
+            somaSaltos += s;
+            if (!simular) {
+                if (insereArco(p->saida, &p->ixSaida, u, x, w, v, s)) p->totalArcos++;
+                insereArco(p->entrada, &p->ixEntrada, x, u, w, v, s);
+            }
+        }
+        limpaTestemunha(p);
+    }
+    for (int j = 0; j < out->nAtivos; j++) p->alvo[out->a[j].to] = false;
+    if (saltos) *saltos = somaSaltos;
+    return atalhos;
+}
+
+// Prioridade = diferença de arestas (atalhos - arcos removidos) + vizinhos
+// já contraídos + profundidade + atalhos / arcos removidos + saltos dos
+// atalhos / saltos removidos. Vizinhos contraídos e profundidade mantêm a
+// ordem espalhada pelo grafo; as razões pesam o custo relativo da
+// contração em nós de grau alto, onde a diferença sozinha acumula atalhos;
+// a profundidade também limita a altura da hierarquia.
+static double prioridade(Preproc* p, int v) {
+    int removidas = 0, saltosRemovidos = 0;
+    for (int k = 0; k < 2; k++) {
+        VetArcos* vet = k == 0 ? &p->entrada[v] : &p->saida[v];
+        for (int i = 0; i < vet->nAtivos; i++) {
+            removidas++;
+            saltosRemovidos += vet->a[i].saltos;
+        }
+    }
+    int saltos;
+    int atalhos = contraiNo(p, v, true, &saltos);
+    double pr = PESO_DIFERENCA * (atalhos - removidas) + PESO_VIZINHOS * p->vizContraidos[v]
+              + PESO_PROFUNDIDADE * p->prof[v];
+    if (removidas == 0) return pr;
+    return pr + PESO_RAZAO * ((double)atalhos / removidas + (double)saltos / saltosRemovidos);
+}
+
+// ----------------------------------------------------------------------------
+// Construção
+// ----------------------------------------------------------------------------
+// Monta um CSR com os arcos de cada nó que levam a um rank maior
+static void montaCSRSubida(CHImpl* ch, VetArcos* vet, int** off, int** to, double** w) {
+    int n = ch->n, m = 0;
+    *off = malloc((n + 1) * sizeof(int));
+    for (int u = 0; u < n; u++)
+        for (int i = 0; i < vet[u].n; i++) if (ch->rank[vet[u].a[i].to] > ch->rank[u]) m++;
+    *to = malloc((m > 0 ? m : 1) * sizeof(int));
+    *w = malloc((m > 0 ? m : 1) * sizeof(double));
+    int pos = 0;
+    for (int u = 0; u < n; u++) {
+        (*off)[u] = pos;
+        for (int i = 0; i < vet[u].n; i++) {
+            Arco* a = &vet[u].a[i];
+            if (ch->rank[a->to] <= ch->rank[u]) continue;
+            (*to)[pos] = a->to; (*w)[pos] = a->w;
+            pos++;
+        }
+    }
+    (*off)[n] = pos;
+}
+
+ContractionHierarchy createContractionHierarchy(Graph g, int crit, CalculaCustoAresta f) {
+    int n = getTotalNodes(g);
+    CHImpl* ch = calloc(1, sizeof(CHImpl));
+    ch->n = n;
+    ch->g = g;
+    ch->versao = getGraphVersion(g);
+    ch->rank = malloc((n > 0 ? n : 1) * sizeof(int));
+
+    Preproc p = {0};
+    p.n = n;
+    p.saida = calloc(n > 0 ? n : 1, sizeof(VetArcos));
+    p.entrada = calloc(n > 0 ? n : 1, sizeof(VetArcos));
+    p.contraido = calloc(n > 0 ? n : 1, sizeof(bool));
+    p.vizContraidos = calloc(n > 0 ? n : 1, sizeof(int));
+    p.prof = calloc(n > 0 ? n : 1, sizeof(int));
+    p.wd = malloc((n > 0 ? n : 1) * sizeof(double));
+    p.saltos = malloc((n > 0 ? n : 1) * sizeof(int));
+    p.alvo = calloc(n > 0 ? n : 1, sizeof(bool));
+    p.wTocados = malloc((n > 0 ? n : 1) * sizeof(int));
+    for (int i = 0; i < n; i++) p.wd[i] = DBL_MAX;
+
+    // Copia as arestas ativas do grafo (laços ignorados, paralelas fundidas)
+    Lista adj = lista_cria();
+    for (int u = 0; u < n; u++) {
+        adjacentEdges(g, u, adj);
+        while (!lista_vazia(adj)) {
+            Edge e = lista_remove_primeiro(adj);
+            int v = getToNode(g, e);
+            if (v == u) continue;
+            double w = f(getEdgeInfo(g, e), crit);
+            if (insereArco(p.saida, &p.ixSaida, u, v, w, -1, 1)) p.totalArcos++;
+            insereArco(p.entrada, &p.ixEntrada, v, u, w, -1, 1);
+        }
+    }
+    lista_libera(adj);
+    p.wpq = createIndexedPriorityQueue(n, PQ_ARIDADE_PADRAO);
+
+    // Ordenação dos nós. A fila aceita entradas repetidas: prio[v] é a
+    // prioridade atual e entradas com outro valor estão velhas.
+    priorityQueue fila = createPriorityQueue(n > 0 ? n : 1);
+    double* prio = malloc((n > 0 ? n : 1) * sizeof(double));
+    for (int v = 0; v < n; v++) { prio[v] = prioridade(&p, v); pq_insert(fila, v, prio[v]); }
+    int nivel = 0;
+    while (!pq_empty(fila)) {
+        double pv = pq_min_prio(fila);
+        int v = pq_extract_min(fila);
+        if (p.contraido[v] || pv != prio[v]) continue;  // Entrada velha
+        // Atualização preguiçosa: contrações a até 2 saltos mudam as
+        // testemunhas de v sem que v seja vizinho delas
+        double pr = prioridade(&p, v);
+        if (pr != pv) {
+            prio[v] = pr;
+            if (!pq_empty(fila) && pr > pq_min_prio(fila)) {
+                pq_insert(fila, v, pr);
+                continue;
+            }
+        }
+        ch->nAtalhos += contraiNo(&p, v, false, NULL);
+        p.contraido[v] = true;
+        ch->rank[v] = nivel++;
+        // Tira v das listas ativas dos vizinhos
+        for (int i = 0; i < p.saida[v].nAtivos; i++)
+            desativaArco(p.entrada, &p.ixEntrada, p.saida[v].a[i].to, v);
+        for (int i = 0; i < p.entrada[v].nAtivos; i++)
+            desativaArco(p.saida, &p.ixSaida, p.entrada[v].a[i].to, v);
+        // Novos atalhos, vizinhos contraídos e a profundidade mudam a
+        // prioridade dos vizinhos; o resto é pego na atualização preguiçosa
+        for (int k = 0; k < 2; k++) {
+            VetArcos* vet = k == 0 ? &p.saida[v] : &p.entrada[v];
+            for (int i = 0; i < vet->nAtivos; i++) {
+                int x = vet->a[i].to;
+                p.vizContraidos[x]++;
+                if (p.prof[x] < p.prof[v] + 1) p.prof[x] = p.prof[v] + 1;
+                double nova = prioridade(&p, x);
+                if (nova != prio[x]) { prio[x] = nova; pq_insert(fila, x, nova); }
+            }
+        }
+    }
+    pq_destroy(fila);
+    free(prio);
+
+    // Grafos de busca: subida para frente (saídas) e para trás (entradas)
+    ch->saida = p.saida;
+    montaCSRSubida(ch, p.saida, &ch->upOff, &ch->upTo, &ch->upW);
+    montaCSRSubida(ch, p.entrada, &ch->dnOff, &ch->dnFrom, &ch->dnW);
+
+    for (int v = 0; v < n; v++) free(p.entrada[v].a);
+    free(p.entrada);
+    free(p.contraido);
+    free(p.vizContraidos);
+    free(p.prof);
+    free(p.wd);
+    free(p.saltos);
+    free(p.alvo);
+    free(p.ixSaida.chave); free(p.ixSaida.pos);
+    free(p.ixEntrada.chave); free(p.ixEntrada.pos);
+    free(p.wTocados);
+    pq_destroy(p.wpq);
+
+    // Área de trabalho das consultas
+    int cap = (ch->upOff[n] > ch->dnOff[n] ? ch->upOff[n] : ch->dnOff[n]) + 1;
+    for (int k = 0; k < 2; k++) {
+        ch->dist[k] = malloc((n > 0 ? n : 1) * sizeof(double));
+        ch->pai[k] = malloc((n > 0 ? n : 1) * sizeof(int));
+        ch->fechado[k] = calloc(n > 0 ? n : 1, sizeof(bool));
+        for (int i = 0; i < n; i++) { ch->dist[k][i] = DBL_MAX; ch->pai[k][i] = -1; }
+        ch->pq[k] = createPriorityQueue(cap);
+    }
+    ch->tocados = malloc((n > 0 ? n : 1) * sizeof(int));
+    ch->seq = malloc((n > 0 ? n : 1) * sizeof(int));
+    ch->pilha = malloc((2*n + 4) * sizeof(int));
+    return ch;
+}
+
+// ----------------------------------------------------------------------------
+// Consulta
+// ----------------------------------------------------------------------------
+static int meioDoArco(CHImpl* ch, int a, int b) {
+    VetArcos* v = &ch->saida[a];
+    for (int i = 0; i < v->n; i++) if (v->a[i].to == b) return v->a[i].meio;
+    return -1;
+}
+
+// Insere na lista os nós do arco a -> b desempacotado (sem `a`).
+// Pilha explícita: atalhos longos não estouram a pilha de chamadas.
+static void desempacota(CHImpl* ch, int a, int b, Lista path, int* pilha) {
+    int topo = 0;
+    pilha[topo++] = a; pilha[topo++] = b;
+    while (topo > 0) {
+        int y = pilha[--topo];
+        int x = pilha[--topo];
+        int m = meioDoArco(ch, x, y);
+        if (m == -1) {
+            lista_insere(path, (void*)(intptr_t)y);
+        } else {
+            // (x, m) precisa sair antes de (m, y): empilha na ordem inversa
+            pilha[topo++] = m; pilha[topo++] = y;
+            pilha[topo++] = x; pilha[topo++] = m;
+        }
+    }
+}
+
+static void marca(CHImpl* ch, int v) {
+    if (ch->dist[0][v] == DBL_MAX && ch->dist[1][v] == DBL_MAX) ch->tocados[ch->nTocados++] = v;
+}
+
+Lista ch_findPath(ContractionHierarchy c, Node start, Node end) {
+    CHImpl* ch = (CHImpl*)c;
+    Lista path = lista_cria();
+
+    marca(ch, start); ch->dist[0][start] = 0; pq_insert(ch->pq[0], start, 0);
+    marca(ch, end);   ch->dist[1][end] = 0;   pq_insert(ch->pq[1], end, 0);
+    double mu = DBL_MAX;
+    int meio = -1;
+
+    while (true) {
+        double topo0 = pq_min_prio(ch->pq[0]), topo1 = pq_min_prio(ch->pq[1]);
+        // Cada lado só precisa continuar enquanto seu topo for menor que mu
+        if ((topo0 < topo1 ? topo0 : topo1) >= mu) break;
+        int lado = topo0 <= topo1 ? 0 : 1;
+        int u = pq_extract_min(ch->pq[lado]);
+        if (ch->fechado[lado][u]) continue;
+        ch->fechado[lado][u] = true;
+        double du = ch->dist[lado][u];
+
+        // Encontro das duas buscas
+        if (ch->dist[1-lado][u] != DBL_MAX && du + ch->dist[1-lado][u] < mu) {
+            mu = du + ch->dist[1-lado][u];
+            meio = u;
+        }
+
+        const int* off = lado == 0 ? ch->upOff : ch->dnOff;
+        const int* viz = lado == 0 ? ch->upTo : ch->dnFrom;
+        const double* w = lado == 0 ? ch->upW : ch->dnW;
+        for (int i = off[u]; i < off[u+1]; i++) {
+            int v = viz[i];
+            double nd = du + w[i];
+            if (nd < ch->dist[lado][v]) {
+                marca(ch, v);
+                ch->dist[lado][v] = nd;
+                ch->pai[lado][v] = u;
+                pq_insert(ch->pq[lado], v, nd);
+            }
+        }
+    }
+
+    if (meio != -1) {
+        // Sequência de nós no grafo com atalhos: start .. meio .. end
+        int* seq = ch->seq;
+        int cnt = 0;
+        for (int v = meio; v != -1; v = ch->pai[0][v]) seq[cnt++] = v;
+        for (int i = 0, j = cnt-1; i < j; i++, j--) { int t = seq[i]; seq[i] = seq[j]; seq[j] = t; }
+        for (int v = ch->pai[1][meio]; v != -1; v = ch->pai[1][v]) seq[cnt++] = v;
+
+        lista_insere(path, (void*)(intptr_t)seq[0]);
+        for (int i = 0; i + 1 < cnt; i++) desempacota(ch, seq[i], seq[i+1], path, ch->pilha);
+    }
+
+    // Reinicia apenas o que a consulta tocou
+    for (int i = 0; i < ch->nTocados; i++) {
+        int v = ch->tocados[i];
+        for (int k = 0; k < 2; k++) {
+            ch->dist[k][v] = DBL_MAX;
+            ch->pai[k][v] = -1;
+            ch->fechado[k][v] = false;
+        }
+    }
+    ch->nTocados = 0;
+    for (int k = 0; k < 2; k++) pq_clear(ch->pq[k]);
+    return path;
+}
+
+bool ch_isStale(ContractionHierarchy c) {
+    CHImpl* ch = (CHImpl*)c;
+    return ch->versao != getGraphVersion(ch->g);
+}
+
+int ch_numShortcuts(ContractionHierarchy c) { return ((CHImpl*)c)->nAtalhos; }
+
+void ch_destroy(ContractionHierarchy c) {
+    CHImpl* ch = (CHImpl*)c;
+    for (int v = 0; v < ch->n; v++) free(ch->saida[v].a);
+    free(ch->saida);
+    free(ch->rank);
+    free(ch->upOff); free(ch->upTo); free(ch->upW);
+    free(ch->dnOff); free(ch->dnFrom); free(ch->dnW);
+    for (int k = 0; k < 2; k++) {
+        free(ch->dist[k]); free(ch->pai[k]); free(ch->fechado[k]);
+        pq_destroy(ch->pq[k]);
+    }
+    free(ch->tocados);
+    free(ch->seq);
+    free(ch->pilha);
+    free(ch);
+}
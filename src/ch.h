@@ -0,0 +1,20 @@
+#ifndef CH_H
+#define CH_H
+#include "graph.h"
+
+// Contraction Hierarchies: pré-processamento que ordena os nós por
+// "importância", contrai um a um inserindo atalhos (shortcuts) e permite
+// responder consultas ponto a ponto com duas buscas pequenas, só "para cima".
+typedef void* ContractionHierarchy;
+
+ContractionHierarchy createContractionHierarchy(Graph g, int crit, CalculaCustoAresta f);
+// Pré-processa `g` com os pesos de `f` no critério `crit`.
+Lista ch_findPath(ContractionHierarchy ch, Node start, Node end);
+// Caminho mínimo start -> end (nós originais do grafo, como findPath).
+// Lista vazia se não houver caminho.
+bool ch_isStale(ContractionHierarchy ch);
+// true se o grafo mudou (getGraphVersion) depois do pré-processamento.
+int ch_numShortcuts(ContractionHierarchy ch);
+void ch_destroy(ContractionHierarchy ch);
+
+#endif
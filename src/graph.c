@@ -1,94 +1,742 @@
 #include "graph.h"
 #include "priority_queue.h"
 #include "utils.h"
+#include "hash.h"
+#include "arena.h"
+#include "fila.h"
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
 #include <float.h>
 #include <stdint.h> // <--- Include para função intptr_t
+#include <pthread.h>
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 // Struct de implementação do grafo
-typedef struct { double x, y; } Coord; 
-typedef struct { Node dest; Info info; } EdgeImpl;
-typedef struct { char* nome; Info info; Lista edges; } NodeImpl;
-typedef struct { NodeImpl* nodes; int max; int count; } GraphImpl;
+// Arestas formam uma lista encadeada intrusiva por nó (prox), alocada na arena:
+// nenhum malloc individual por aresta nem nó de Lista separado
+// `pos` é a posição da aresta no snapshot CSR (permite atualizar seu peso em O(1)).
+// Arestas removidas continuam na lista (para restoreEdge), mas são ignoradas.
+// Cada aresta também está na lista de entrada do destino (proxEntrada).
+typedef struct EdgeImpl {
+    Node orig, dest; Info info;
+    struct EdgeImpl* prox;         // Próxima aresta saindo de orig
+    struct EdgeImpl* proxEntrada;  // Próxima aresta chegando em dest
+    struct EdgeImpl* proxHash;     // Próxima aresta no mesmo balde do índice (u,v)
+    int pos; bool removida;
+    int perfil;                    // Perfil de tempo no pool do grafo (-1 = nenhum)
+} EdgeImpl;
+typedef struct {
+    char* nome; Info info;
+    EdgeImpl* prim; EdgeImpl* ult;                // Arestas de saída
+    EdgeImpl* primEntrada; EdgeImpl* ultEntrada;  // Arestas de entrada
+} NodeImpl;
+
+// Snapshot CSR (Compressed Sparse Row) gerado por freezeGraph.
+// As arestas de u ocupam as posições [off[u], off[u+1]) de dest/peso,
+// de modo que a relaxação percorre memória contígua em vez da Lista.
+// Linhas e destinos usam ids internos (ver reorderGraph).
+typedef struct {
+    int* off;                     // n+1 offsets
+    Node* dest;                   // destino de cada aresta
+    double* peso[NUM_CRITERIOS];  // peso de cada aresta por critério
+    uint32_t* pesoQ[NUM_CRITERIOS]; // peso * escalaQ arredondado (NULL = desligado)
+    int n, m;                     // nós e arestas no momento do freeze
+    CalculaCustoAresta f;         // função usada para gerar os pesos
+    bool valido;                  // false se o grafo mudou após o freeze
+    // CSR reverso (arestas de entrada), construído sob demanda a partir do
+    // direto. rpos aponta para a posição da aresta no CSR direto, de modo
+    // que os pesos têm uma única cópia (e setEdgeAttr vale para os dois).
+    int* roff;
+    Node* rorig;
+    int* rpos;
+    bool reversoValido;
+    // Coordenadas na numeração interna e escala da heurística do A*:
+    // h(v) = escalaH[crit] * |v - destino|, com escalaH = min(peso / |uv|)
+    // sobre todas as arestas (calculada sob demanda)
+    double* cx;
+    double* cy;
+    double escalaH[NUM_CRITERIOS];
+    bool escalaValida[NUM_CRITERIOS];
+    // Parâmetros da fila de baldes (FILA_BALDES) por critério: largura =
+    // menor peso; calculados sob demanda, 0 se a fila não se aplica
+    double larguraBalde[NUM_CRITERIOS];
+    int nBaldes[NUM_CRITERIOS];
+    bool baldesValidos[NUM_CRITERIOS];
+    // Perfil de tempo de cada aresta (ver setEdgeProfile), montado sob
+    // demanda por findPathTD; NULL até lá
+    int* perfil;
+    // Tabela de conversões por aresta de chegada: as conversões a partir da
+    // aresta i ficam em [toff[i], toff[i+1]) de tpara/tcusto (posições do
+    // CSR; INFINITY = proibida). eorig[i] é a origem da aresta i.
+    // Montada sob demanda por findPathTurns.
+    int* toff;
+    int* tpara;
+    double* tcusto;
+    int* eorig;
+    bool conversoesValidas;
+} CSRImpl;
+
+// Perfil de tempo periódico: pontos (t, fator) em ptT/ptF[ini, ini+n) do
+// pool, com t crescente em [0, PERIODO_PERFIL). Entre os pontos o fator é
+// interpolado linearmente, e o último liga ao primeiro do período seguinte.
+// inclMin é a menor inclinação (fator por segundo), usada na checagem FIFO.
+typedef struct {
+    int ini, n;
+    double inclMin;
+    uint64_t hash;  // Dos pontos (ver hashPerfil)
+    int prox;       // Próximo perfil no mesmo balde de baldesPerfil (-1 = fim)
+} PerfilImpl;
+
+typedef struct {
+    EdgeImpl* de;    // Aresta u -> v
+    EdgeImpl* para;  // Aresta v -> w
+    double custo;    // INFINITY = proibida
+    int prox;        // Próxima conversão no mesmo balde de baldesConversao (-1 = fim)
+} ConversaoImpl;
+
+typedef struct {
+    NodeImpl* nodes; int max; int count; int nEdges;
+    double* x;         // Coordenadas em estrutura de arrays (SoA):
+    double* y;         // x[i], y[i] do nó i, contíguos para varreduras
+    hashTable indice;  // nome -> id, mantido por addNode
+    Arena arena;       // Nomes, arestas e infos de vias/nós do grafo
+    int* interno;      // id externo -> id interno no snapshot (NULL = identidade)
+    int* externo;      // id interno -> id externo
+    int nOrdem;        // quantos nós a numeração interna cobre
+    unsigned long versao; // Incrementada a cada mudança de topologia ou peso
+    EdgeImpl** baldes; // Índice (u,v) -> aresta, encadeado pelas próprias arestas
+    int nBaldes;       // Potência de 2
+    CSRImpl csr;
+    SearchContext ctxPadrao; // Área de trabalho de findPath (criada no 1º uso)
+    double escalaQ[NUM_CRITERIOS]; // Pesos inteiros por critério (0 = desligado)
+    SearchContext* ctxLote; // Uma área de trabalho por thread de findPathBatch
+    int nCtxLote;
+    struct PoolLote* poolLote; // Threads de findPathBatch (criadas no 1º lote)
+    int nThreadsLote;       // 0 = LOTE_THREADS_PADRAO
+    // Pool de perfis de tempo compartilhado pelas arestas: perfis iguais
+    // são guardados uma vez só (ver createTimeProfile)
+    PerfilImpl* perfis; int nPerfis, capPerfis;
+    int* baldesPerfil; int nBaldesPerfil; // Índice por conteúdo, encadeado pelos perfis
+    double* ptT; double* ptF; int nPontos, capPontos;
+    // Conversões (de, para), uma por par: redefinir troca o custo no lugar
+    // (ver setTurnCost). O índice pelo par é encadeado pelas conversões.
+    ConversaoImpl* conversoes; int nConversoes, capConversoes;
+    int* baldesConversao; int nBaldesConversao;
+    double custoRetorno;  // Retorno sem entrada na tabela (INFINITY = proibido)
+} GraphImpl;
+
+#define CAPACIDADE_INICIAL 16
 
 Graph createGraph(int n, bool dir, char* nome) {
+    if (n < 1) n = CAPACIDADE_INICIAL;
     GraphImpl* g = calloc(1, sizeof(GraphImpl));
     g->nodes = calloc(n, sizeof(NodeImpl));
+    g->x = calloc(n, sizeof(double));
+    g->y = calloc(n, sizeof(double));
     g->max = n;
+    g->arena = arena_cria(0);
+    g->indice = createHashTableArena(2*n + 1, g->arena); // Chave = nome já na arena
+    g->nBaldes = 16;
+    g->baldes = calloc(g->nBaldes, sizeof(EdgeImpl*));
     return g;
 }
 
+static void liberaCSR(CSRImpl* c);
+static void encerraPool(struct PoolLote* P);
+
+void destroyGraph(Graph g) {
+    GraphImpl* G = (GraphImpl*)g;
+    liberaCSR(&G->csr);
+    if (G->ctxPadrao) destroySearchContext(G->ctxPadrao);
+    encerraPool(G->poolLote);  // Antes das áreas de trabalho que as threads usam
+    for (int i = 0; i < G->nCtxLote; i++) destroySearchContext(G->ctxLote[i]);
+    free(G->ctxLote);
+    hashTableDestroy(G->indice);
+    free(G->interno);
+    free(G->externo);
+    free(G->baldes);
+    free(G->perfis);
+    free(G->baldesPerfil);
+    free(G->ptT);
+    free(G->ptF);
+    free(G->conversoes);
+    free(G->baldesConversao);
+    arena_libera(G->arena);  // Arestas, nomes e tudo que veio de getGraphArena
+    free(G->nodes);
+    free(G->x);
+    free(G->y);
+    free(G);
+}
+
+Arena getGraphArena(Graph g) { return ((GraphImpl*)g)->arena; }
+
 Node addNode(Graph g, char* nome, Info info) {
     GraphImpl* G = (GraphImpl*)g;
-    if (G->count >= G->max) return -1;
+    // Crescimento por dobra: custo amortizado O(1) e ids continuam válidos
+    if (G->count >= G->max) {
+        int novoMax = 2*G->max;
+        NodeImpl* novos = realloc(G->nodes, novoMax * sizeof(NodeImpl));
+        if (!novos) return -1;
+        G->nodes = novos;
+        double* nx = realloc(G->x, novoMax * sizeof(double));
+        if (nx) G->x = nx;
+        double* ny = realloc(G->y, novoMax * sizeof(double));
+        if (ny) G->y = ny;
+        if (!nx || !ny) return -1;
+        G->max = novoMax;
+    }
     int id = G->count++;
-    G->nodes[id].nome = duplicar_string(nome);
+    G->nodes[id].nome = arena_duplica_string(G->arena, nome);
     G->nodes[id].info = info;
-    G->nodes[id].edges = lista_cria();
+    G->nodes[id].prim = G->nodes[id].ult = NULL;
+    G->nodes[id].primEntrada = G->nodes[id].ultEntrada = NULL;
+    G->x[id] = G->y[id] = 0;
+    // Nomes repetidos continuam resolvendo para o primeiro nó inserido
+    if (!hashGet(G->indice, nome, NULL)) hashPut(G->indice, G->nodes[id].nome, id);
+    G->csr.valido = false;
+    G->versao++;
     return id;
 }
 
+// Espalha o par (u,v) pelos bits altos (hash multiplicativo de Fibonacci)
+static unsigned baldeDe(Node u, Node v, int nBaldes) {
+    uint64_t k = ((uint64_t)(uint32_t)u << 32) | (uint32_t)v;
+    k *= 0x9E3779B97F4A7C15ULL;
+    return (unsigned)(k >> 32) & (unsigned)(nBaldes - 1);
+}
+
+// Dobra o índice (u,v) reaproveitando os próprios nós (arestas)
+static void crescerIndiceArestas(GraphImpl* G) {
+    int novo = 2*G->nBaldes;
+    EdgeImpl** baldes = calloc(novo, sizeof(EdgeImpl*));
+    // Percorre as cadeias em ordem e reinsere no final para manter a ordem
+    // relativa (mais recente primeiro) dentro de cada balde
+    EdgeImpl** ult = calloc(novo, sizeof(EdgeImpl*));
+    for (int b = 0; b < G->nBaldes; b++) {
+        EdgeImpl* e = G->baldes[b];
+        while (e) {
+            EdgeImpl* prox = e->proxHash;
+            unsigned nb = baldeDe(e->orig, e->dest, novo);
+            e->proxHash = NULL;
+            if (ult[nb]) ult[nb]->proxHash = e;
+            else baldes[nb] = e;
+            ult[nb] = e;
+            e = prox;
+        }
+    }
+    free(ult);
+    free(G->baldes);
+    G->baldes = baldes;
+    G->nBaldes = novo;
+}
+
 Edge addEdge(Graph g, Node u, Node v, Info info) {
     GraphImpl* G = (GraphImpl*)g;
-    EdgeImpl* e = malloc(sizeof(EdgeImpl));
+    EdgeImpl* e = arena_aloca(G->arena, sizeof(EdgeImpl));
+    e->orig = u;
     e->dest = v;
     e->info = info;
-    lista_insere(G->nodes[u].edges, e);
+    e->prox = NULL;
+    e->proxEntrada = NULL;
+    e->pos = -1;
+    e->removida = false;
+    e->perfil = -1;
+    // Insere no final para preservar a ordem de inserção das arestas
+    NodeImpl* no = &G->nodes[u];
+    if (no->ult) no->ult->prox = e;
+    else no->prim = e;
+    no->ult = e;
+    // E no final da lista de entrada de v (adjacência reversa)
+    NodeImpl* alvo = &G->nodes[v];
+    if (alvo->ultEntrada) alvo->ultEntrada->proxEntrada = e;
+    else alvo->primEntrada = e;
+    alvo->ultEntrada = e;
+    // Índice (u,v): inserção no início do balde, a mais recente vem primeiro
+    unsigned b = baldeDe(u, v, G->nBaldes);
+    e->proxHash = G->baldes[b];
+    G->baldes[b] = e;
+    G->nEdges++;
+    if (G->nEdges > G->nBaldes) crescerIndiceArestas(G);
+    G->csr.valido = false;
+    G->versao++;
     return e;
 }
 
 int getTotalNodes(Graph g) { return ((GraphImpl*)g)->count; }
+unsigned long getGraphVersion(Graph g) { return ((GraphImpl*)g)->versao; }
 Info getNodeInfo(Graph g, Node n) { return ((GraphImpl*)g)->nodes[n].info; }
 
+// Consulta O(1) esperado no índice nome -> id
 Node getNode(Graph g, char* nome) {
     GraphImpl* G = (GraphImpl*)g;
-    for(int i=0; i<G->count; i++) 
-        if(strcmp(G->nodes[i].nome, nome)==0) return i;
+    int id;
+    if (hashGet(G->indice, nome, &id)) return id;
     return -1;
 }
 
 void adjacentEdges(Graph g, Node n, Lista l) {
     GraphImpl* G = (GraphImpl*)g;
-    Lista edges = G->nodes[n].edges;
-    Iterador it = lista_iterador(edges);
-    while(iterador_tem_proximo(it)) 
-        lista_insere(l, iterador_proximo(it));
-    iterador_destroi(it);
+    for (EdgeImpl* e = G->nodes[n].prim; e; e = e->prox)
+        if (!e->removida) lista_insere(l, e);
 }
 
 // --- 
 void adjacentNodes(Graph g, Node n, Lista l) {
     GraphImpl* G = (GraphImpl*)g;
-    Lista edges = G->nodes[n].edges;
-    Iterador it = lista_iterador(edges);
-    while(iterador_tem_proximo(it)) {
-        EdgeImpl* e = (EdgeImpl*)iterador_proximo(it);
+    for (EdgeImpl* e = G->nodes[n].prim; e; e = e->prox) {
+        if (e->removida) continue;
         // Insere o índice do nó destino na lista.
         // Usa cast através de `intptr_t` para armazenar inteiros em `void*`.
         lista_insere(l, (void*)(intptr_t)e->dest);
     }
-    iterador_destroi(it);
 }
 // ---------------------------------------------
 
+// Adjacência reversa: arestas (e nós de origem) que chegam em `n`
+void incomingEdges(Graph g, Node n, Lista l) {
+    GraphImpl* G = (GraphImpl*)g;
+    for (EdgeImpl* e = G->nodes[n].primEntrada; e; e = e->proxEntrada)
+        if (!e->removida) lista_insere(l, e);
+}
+
+void incomingNodes(Graph g, Node n, Lista l) {
+    GraphImpl* G = (GraphImpl*)g;
+    for (EdgeImpl* e = G->nodes[n].primEntrada; e; e = e->proxEntrada)
+        if (!e->removida) lista_insere(l, (void*)(intptr_t)e->orig);
+}
+
+// O(1) esperado, sem alocação: consulta o índice (u,v)
+Edge findEdge(Graph g, Node u, Node v) {
+    GraphImpl* G = (GraphImpl*)g;
+    for (EdgeImpl* e = G->baldes[baldeDe(u, v, G->nBaldes)]; e; e = e->proxHash)
+        if (e->orig == u && e->dest == v && !e->removida) return e;
+    return NULL;
+}
+
 Node getToNode(Graph g, Edge e) { return ((EdgeImpl*)e)->dest; }
+Node getFromNode(Graph g, Edge e) { return ((EdgeImpl*)e)->orig; }
 Info getEdgeInfo(Graph g, Edge e) { return ((EdgeImpl*)e)->info; }
 
+// Troca (ou confirma, após alteração in-place) o Info da aresta e recalcula
+// apenas as entradas dessa aresta nas colunas de peso: O(NUM_CRITERIOS)
+// Peso inteiro: arredonda peso * escala; infinito ou fora de uint32 vira
+// PESO_Q_INF (aresta ignorada pela busca inteira)
+#define PESO_Q_INF UINT32_MAX
+static uint32_t quantiza(double w, double escala) {
+    double q = w * escala + 0.5;
+    return (q >= 0 && q < (double)PESO_Q_INF) ? (uint32_t)q : PESO_Q_INF;
+}
+
+// Reescreve os pesos da aresta no snapshot (infinito se removida)
+static void atualizaPesos(GraphImpl* G, EdgeImpl* a) {
+    CSRImpl* c = &G->csr;
+    if (!c->valido || a->pos < 0) return;
+    for (int k = 0; k < NUM_CRITERIOS; k++) {
+        c->peso[k][a->pos] = a->removida ? INFINITY : c->f(a->info, k);
+        if (c->pesoQ[k]) c->pesoQ[k][a->pos] = quantiza(c->peso[k][a->pos], G->escalaQ[k]);
+        c->escalaValida[k] = false;  // Um peso menor pode reduzir a escala do A*
+        c->baldesValidos[k] = false; // ... e a largura dos baldes
+    }
+}
+
+void setEdgeAttr(Graph g, Edge e, Info info) {
+    GraphImpl* G = (GraphImpl*)g;
+    EdgeImpl* a = (EdgeImpl*)e;
+    a->info = info;
+    atualizaPesos(G, a);
+    G->versao++;
+}
+
+// Remoção lógica: a aresta fica no snapshot com peso infinito, de modo que
+// remover/restaurar não exige reconstruir o CSR
+void removeEdge(Graph g, Edge e) {
+    GraphImpl* G = (GraphImpl*)g;
+    EdgeImpl* a = (EdgeImpl*)e;
+    if (a->removida) return;
+    a->removida = true;
+    atualizaPesos(G, a);
+    G->versao++;
+}
+
+void restoreEdge(Graph g, Edge e) {
+    GraphImpl* G = (GraphImpl*)g;
+    EdgeImpl* a = (EdgeImpl*)e;
+    if (!a->removida) return;
+    a->removida = false;
+    atualizaPesos(G, a);
+    G->versao++;
+}
+
+bool isEdgeRemoved(Graph g, Edge e) { return ((EdgeImpl*)e)->removida; }
+
+void setNodeCoord(Graph g, Node n, double x, double y) {
+    GraphImpl* G = (GraphImpl*)g;
+    G->x[n] = x;
+    G->y[n] = y;
+    CSRImpl* c = &G->csr;
+    if (c->valido && n < c->n) {
+        int i = G->interno ? G->interno[n] : n;
+        c->cx[i] = x;
+        c->cy[i] = y;
+        for (int k = 0; k < NUM_CRITERIOS; k++) c->escalaValida[k] = false;
+    }
+}
+
+void getNodeCoord(Graph g, Node n, double* x, double* y) {
+    GraphImpl* G = (GraphImpl*)g;
+    if (x) *x = G->x[n];
+    if (y) *y = G->y[n];
+}
+
+// Busca exaustiva vetorizada sobre os arrays x[]/y[].
+// Cada lane guarda seu melhor (distância, índice); no final as lanes são
+// reduzidas escolhendo o menor índice em caso de empate, o que reproduz
+// exatamente o resultado da varredura escalar com `<`.
 Node findNearestNode(Graph g, double x, double y) {
     GraphImpl* G = (GraphImpl*)g;
+    const double* xs = G->x;
+    const double* ys = G->y;
+    int n = G->count;
     int best = -1;
     double minD = DBL_MAX;
+    int i = 0;
     
-    for(int i=0; i<G->count; i++) {
-        Coord* c = (Coord*)G->nodes[i].info;
-        double d = (c->x - x)*(c->x - x) + (c->y - y)*(c->y - y);
+#if defined(__AVX__)
+    if (n >= 4) {
+        __m256d px = _mm256_set1_pd(x), py = _mm256_set1_pd(y);
+        __m256d bestD = _mm256_set1_pd(DBL_MAX);
+        __m256d bestI = _mm256_set1_pd(-1.0);
+        __m256d idx = _mm256_set_pd(3, 2, 1, 0);
+        __m256d passo = _mm256_set1_pd(4);
+        for (; i + 4 <= n; i += 4) {
+            __m256d dx = _mm256_sub_pd(_mm256_loadu_pd(xs + i), px);
+            __m256d dy = _mm256_sub_pd(_mm256_loadu_pd(ys + i), py);
+            __m256d d = _mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy));
+            __m256d menor = _mm256_cmp_pd(d, bestD, _CMP_LT_OQ);
+            bestD = _mm256_blendv_pd(bestD, d, menor);
+            bestI = _mm256_blendv_pd(bestI, idx, menor);
+            idx = _mm256_add_pd(idx, passo);
+        }
+        double ld[4], li[4];
+        _mm256_storeu_pd(ld, bestD);
+        _mm256_storeu_pd(li, bestI);
+        for (int k = 0; k < 4; k++) {
+            if (li[k] < 0) continue;
+            if (ld[k] < minD || (ld[k] == minD && (int)li[k] < best)) { minD = ld[k]; best = (int)li[k]; }
+        }
+    }
+#elif defined(__SSE2__)
+    if (n >= 2) {
+        __m128d px = _mm_set1_pd(x), py = _mm_set1_pd(y);
+        __m128d bestD = _mm_set1_pd(DBL_MAX);
+        __m128d bestI = _mm_set1_pd(-1.0);
+        __m128d idx = _mm_set_pd(1, 0);
+        __m128d passo = _mm_set1_pd(2);
+        for (; i + 2 <= n; i += 2) {
+            __m128d dx = _mm_sub_pd(_mm_loadu_pd(xs + i), px);
+            __m128d dy = _mm_sub_pd(_mm_loadu_pd(ys + i), py);
+            __m128d d = _mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy));
+            __m128d menor = _mm_cmplt_pd(d, bestD);
+            // SSE2 não tem blend: seleção via máscara (and/andnot/or)
+            bestD = _mm_or_pd(_mm_and_pd(menor, d), _mm_andnot_pd(menor, bestD));
+            bestI = _mm_or_pd(_mm_and_pd(menor, idx), _mm_andnot_pd(menor, bestI));
+            idx = _mm_add_pd(idx, passo);
+        }
+        double ld[2], li[2];
+        _mm_storeu_pd(ld, bestD);
+        _mm_storeu_pd(li, bestI);
+        for (int k = 0; k < 2; k++) {
+            if (li[k] < 0) continue;
+            if (ld[k] < minD || (ld[k] == minD && (int)li[k] < best)) { minD = ld[k]; best = (int)li[k]; }
+        }
+    }
+#endif
+    
+    // Cauda (ou caminho escalar quando não há SIMD)
+    for (; i < n; i++) {
+        double d = (xs[i] - x)*(xs[i] - x) + (ys[i] - y)*(ys[i] - y);
         if (d < minD) { minD = d; best = i; }
     }
     return best;
 }
 
+// ============================================================================
+// SNAPSHOT CSR
+// ============================================================================
+// Reconstrói caminho start -> end a partir do vetor de predecessores.
+// `pai` usa ids internos; a lista devolvida usa ids externos.
+// O vetor temporário tem o tamanho do caminho, não de n.
+static Lista reconstroiCaminho(GraphImpl* G, int* pai, int end, int n) {
+    Lista path = lista_cria();
+    int count = 0;
+    for (int curr = end; curr != -1 && count <= n; curr = pai[curr]) count++;
+    int* temp = malloc((count > 0 ? count : 1) * sizeof(int));
+    int i = count;
+    for (int curr = end; i > 0; curr = pai[curr]) temp[--i] = curr;
+    for (i = 0; i < count; i++) {
+        int v = G->externo ? G->externo[temp[i]] : temp[i];
+        lista_insere(path, (void*)(intptr_t)v);
+    }
+    free(temp);
+    return path;
+}
+
+// Estende a numeração interna para nós adicionados depois de reorderGraph:
+// eles ocupam as posições finais, na ordem de inserção
+static void garanteOrdem(GraphImpl* G) {
+    if (!G->interno || G->nOrdem == G->count) return;
+    G->interno = realloc(G->interno, G->max * sizeof(int));
+    G->externo = realloc(G->externo, G->max * sizeof(int));
+    for (int i = G->nOrdem; i < G->count; i++) G->interno[i] = G->externo[i] = i;
+    G->nOrdem = G->count;
+}
+
+static void liberaCSR(CSRImpl* c) {
+    free(c->off);
+    free(c->dest);
+    for (int k = 0; k < NUM_CRITERIOS; k++) {
+        free(c->peso[k]);
+        free(c->pesoQ[k]);
+        c->pesoQ[k] = NULL;
+    }
+    free(c->roff);
+    free(c->rorig);
+    free(c->rpos);
+    c->roff = NULL; c->rorig = NULL; c->rpos = NULL;
+    c->reversoValido = false;
+    free(c->cx);
+    free(c->cy);
+    free(c->perfil);
+    c->perfil = NULL;
+    free(c->toff);
+    free(c->tpara);
+    free(c->tcusto);
+    free(c->eorig);
+    c->toff = NULL; c->tpara = NULL; c->tcusto = NULL; c->eorig = NULL;
+    c->conversoesValidas = false;
+}
+
+// Transpõe o CSR direto (contagem por destino): O(V + E)
+static void garanteReverso(CSRImpl* c) {
+    if (c->reversoValido) return;
+    int n = c->n, m = c->m;
+    c->roff = calloc(n + 1, sizeof(int));
+    c->rorig = malloc((m > 0 ? m : 1) * sizeof(Node));
+    c->rpos = malloc((m > 0 ? m : 1) * sizeof(int));
+    for (int i = 0; i < m; i++) c->roff[c->dest[i] + 1]++;
+    for (int v = 0; v < n; v++) c->roff[v+1] += c->roff[v];
+    int* prox = malloc((n > 0 ? n : 1) * sizeof(int));
+    memcpy(prox, c->roff, n * sizeof(int));
+    for (int u = 0; u < n; u++) {
+        for (int i = c->off[u]; i < c->off[u+1]; i++) {
+            int k = prox[c->dest[i]]++;
+            c->rorig[k] = u;
+            c->rpos[k] = i;
+        }
+    }
+    free(prox);
+    c->reversoValido = true;
+}
+
+// ============================================================================
+// ÁREA DE TRABALHO DAS BUSCAS
+// ============================================================================
+// dist/pai/fila alocados uma vez e reaproveitados. Em vez de reinicializar os
+// n nós a cada consulta, cada consulta tem uma geração: geracao[v] != atual
+// significa que dist[v], pai[v] e o bit de v em `visitado` são lixo de uma
+// consulta anterior e são reiniciados no primeiro toque. Assim o custo de
+// preparação é proporcional aos nós alcançados, não a V.
+// ============================================================================
+typedef struct SearchContextImpl {
+    int cap;             // Nós com espaço alocado em pai/geracao/visitado
+    double* dist;        // Rótulos double (alocados no 1º uso: ver reservaContexto)
+    int capD;
+    int* pai;
+    unsigned* geracao;
+    unsigned atual;
+    uint64_t* visitado;  // Bit v: v já foi fechado (entradas velhas são puladas)
+    uint32_t* distQ;     // Rótulos da busca inteira (alocados no 1º uso)
+    int capQ;
+    priorityQueue pq;
+    int tipoFila;        // FILA_* pedida (setSearchQueue)
+    int filaCriada;      // FILA_* de `pq` (pode cair para radix)
+    double larguraFila;  // Largura dos baldes de `pq`
+    struct SearchContextImpl* tras; // Lado de trás da busca bidirecional (1º uso)
+} SearchContextImpl;
+
+SearchContext createSearchContext(void) {
+    return calloc(1, sizeof(SearchContextImpl));  // FILA_HEAP
+}
+
+void setSearchQueue(SearchContext ctx, int fila) {
+    ((SearchContextImpl*)ctx)->tipoFila = fila;
+}
+
+void destroySearchContext(SearchContext ctx) {
+    SearchContextImpl* s = (SearchContextImpl*)ctx;
+    free(s->dist);
+    free(s->pai);
+    free(s->geracao);
+    free(s->visitado);
+    free(s->distQ);
+    if (s->pq) pq_destroy(s->pq);
+    if (s->tras) destroySearchContext(s->tras);
+    free(s);
+}
+
+// Baldes de Dial são exatos com largura = menor peso, e a janela circular
+// precisa cobrir o maior peso. Sem pesos positivos (arestas de peso 0) ou
+// com razão maior/menor grande demais, a fila de baldes não compensa.
+#define LIMITE_BALDES (1 << 22)
+static bool parametrosBaldes(CSRImpl* c, int crit, double* largura, int* nBaldes) {
+    if (!c->baldesValidos[crit]) {
+        double menor = DBL_MAX, maior = 0;
+        for (int i = 0; i < c->off[c->n]; i++) {
+            double w = c->peso[crit][i];
+            if (w == INFINITY) continue;  // Removida
+            if (w < menor) menor = w;
+            if (w > maior) maior = w;
+        }
+        bool ok = menor > 0 && menor != DBL_MAX && maior / menor < LIMITE_BALDES;
+        c->larguraBalde[crit] = ok ? menor : 0;
+        c->nBaldes[crit] = ok ? (int)(maior / menor) + 2 : 0;
+        c->baldesValidos[crit] = true;
+    }
+    *largura = c->larguraBalde[crit];
+    *nBaldes = c->nBaldes[crit];
+    return *largura > 0;
+}
+
+// Recria a fila só se o tipo (ou a largura dos baldes) mudou
+static void preparaFila(SearchContextImpl* s, CSRImpl* c, int crit, int tipo) {
+    double largura = 0;
+    int nBaldes = 0;
+    if (tipo == FILA_BALDES && !parametrosBaldes(c, crit, &largura, &nBaldes)) tipo = FILA_RADIX;
+    if (s->pq && s->filaCriada == tipo && s->larguraFila == largura) {
+        pq_clear(s->pq);
+        return;
+    }
+    if (s->pq) pq_destroy(s->pq);
+    if (tipo == FILA_RADIX) s->pq = createRadixHeap();
+    else if (tipo == FILA_BALDES) s->pq = createBucketQueue(largura, nBaldes);
+    else s->pq = createIndexedPriorityQueue(c->n, PQ_ARIDADE_PADRAO);
+    s->filaCriada = tipo;
+    s->larguraFila = largura;
+}
+
+// Garante pai/geracao/visitado para estados 0..n-1 (nós, ou arestas na
+// busca por arestas). Os rótulos ficam de fora: cada busca reserva os seus.
+static void reservaEstados(SearchContextImpl* s, int n) {
+    if (s->cap < n) {
+        int cap = s->cap ? s->cap : CAPACIDADE_INICIAL;
+        while (cap < n) cap *= 2;
+        s->pai = realloc(s->pai, cap * sizeof(int));
+        s->geracao = realloc(s->geracao, cap * sizeof(unsigned));
+        s->visitado = realloc(s->visitado, ((cap + 63) / 64) * sizeof(uint64_t));
+        // Posições novas ficam com geração 0, que nunca é a atual
+        memset(s->geracao + s->cap, 0, (cap - s->cap) * sizeof(unsigned));
+        s->cap = cap;
+    }
+}
+
+// Estados 0..n-1 com rótulos double
+static void reservaContexto(SearchContextImpl* s, int n) {
+    reservaEstados(s, n);
+    if (s->capD < s->cap) {
+        s->dist = realloc(s->dist, s->cap * sizeof(double));
+        s->capD = s->cap;
+    }
+}
+
+// Invalida dist/pai/visitado de todos os estados em O(1)
+static void novaGeracao(SearchContextImpl* s) {
+    if (++s->atual == 0) {
+        // Deu a volta no contador: zera tudo uma vez
+        memset(s->geracao, 0, s->cap * sizeof(unsigned));
+        s->atual = 1;
+    }
+}
+
+// Garante espaço para n nós, prepara a fila e abre uma nova geração
+static void preparaContexto(SearchContextImpl* s, CSRImpl* c, int crit, int tipoFila) {
+    reservaContexto(s, c->n);
+    preparaFila(s, c, crit, tipoFila);
+    novaGeracao(s);
+}
+
+static inline void tocaNo(SearchContextImpl* s, int v) {
+    if (s->geracao[v] == s->atual) return;
+    s->geracao[v] = s->atual;
+    s->dist[v] = DBL_MAX;
+    s->pai[v] = -1;
+    s->visitado[v >> 6] &= ~(1ULL << (v & 63));
+}
+
+// Só vale para nós já tocados nesta geração
+static inline bool foiVisitado(const SearchContextImpl* s, int v) {
+    return (s->visitado[v >> 6] >> (v & 63)) & 1;
+}
+
+static inline void marcaVisitado(SearchContextImpl* s, int v) {
+    s->visitado[v >> 6] |= 1ULL << (v & 63);
+}
+
+static SearchContextImpl* contextoPadrao(GraphImpl* G) {
+    if (!G->ctxPadrao) G->ctxPadrao = createSearchContext();
+    return (SearchContextImpl*)G->ctxPadrao;
+}
+
+// Coluna inteira do critério a partir da coluna double do snapshot
+static void montaPesosQ(GraphImpl* G, int crit) {
+    CSRImpl* c = &G->csr;
+    int m = c->off[c->n];
+    if (!c->pesoQ[crit]) c->pesoQ[crit] = malloc((m > 0 ? m : 1) * sizeof(uint32_t));
+    for (int i = 0; i < m; i++) c->pesoQ[crit][i] = quantiza(c->peso[crit][i], G->escalaQ[crit]);
+}
+
+void freezeGraph(Graph g, CalculaCustoAresta f) {
+    GraphImpl* G = (GraphImpl*)g;
+    CSRImpl* c = &G->csr;
+    liberaCSR(c);
+    
+    int n = G->count, m = G->nEdges;
+    c->n = n; c->m = m; c->f = f;
+    c->off = malloc((n + 1) * sizeof(int));
+    c->dest = malloc((m > 0 ? m : 1) * sizeof(Node));
+    for (int k = 0; k < NUM_CRITERIOS; k++)
+        c->peso[k] = malloc((m > 0 ? m : 1) * sizeof(double));
+    c->cx = malloc((n > 0 ? n : 1) * sizeof(double));
+    c->cy = malloc((n > 0 ? n : 1) * sizeof(double));
+    for (int k = 0; k < NUM_CRITERIOS; k++) c->escalaValida[k] = c->baldesValidos[k] = false;
+    
+    // Copia as listas de adjacência linha por linha, na numeração interna
+    garanteOrdem(G);
+    const int* interno = G->interno;
+    int pos = 0;
+    for (int r = 0; r < n; r++) {
+        int u = G->externo ? G->externo[r] : r;
+        c->cx[r] = G->x[u];
+        c->cy[r] = G->y[u];
+        c->off[r] = pos;
+        for (EdgeImpl* e = G->nodes[u].prim; e; e = e->prox) {
+            e->pos = pos;
+            c->dest[pos] = interno ? interno[e->dest] : e->dest;
+            for (int k = 0; k < NUM_CRITERIOS; k++)
+                c->peso[k][pos] = e->removida ? INFINITY : f(e->info, k);
+            pos++;
+        }
+    }
+    c->off[n] = pos;
+    c->valido = true;
+    for (int k = 0; k < NUM_CRITERIOS; k++)
+        if (G->escalaQ[k] > 0) montaPesosQ(G, k);
+}
+
 // ============================================================================
 // ALGORITMO DE DIJKSTRA - Caminho mais curto em grafos com pesos positivos
 // ============================================================================
@@ -97,22 +745,28 @@ Node findNearestNode(Graph g, double x, double y) {
 // Saída: lista com nós do caminho mais curto (ou vazia se sem caminho)
 // Complexidade: O((V + E) log V) onde V=vértices, E=arestas
 // Baseado em Sedgewick - Algoritmos em C, seção 21 (Shortest Paths)
+//
+// Os pesos vêm das colunas pré-calculadas do snapshot CSR: a função `f` só é
+// chamada quando o snapshot é (re)construído, não a cada relaxação.
+// dist/pai/fila vêm da área de trabalho `s` (ver SearchContext).
 // ============================================================================
-Lista findPath(Graph g, Node start, Node end, int crit, CalculaCustoAresta f) {
-    GraphImpl* G = (GraphImpl*)g;
-    int n = G->count;
+static Lista dijkstraCSR(GraphImpl* G, SearchContextImpl* s, Node start, Node end, int crit) {
+    CSRImpl* c = &G->csr;
+    int n = c->n;
+    const int* off = c->off;
+    const Node* dest = c->dest;
+    const double* peso = c->peso[crit];  // Coluna do critério: relaxar = 1 load
+    if (G->interno) { start = G->interno[start]; end = G->interno[end]; }
     
-    // Pré-processamento: inicialização de distâncias e predecessores
-    double* dist = malloc(n * sizeof(double));  // dist[v] = menor distância de start até v
-    int* pai = malloc(n * sizeof(int));         // pai[v] = nó anterior no caminho ótimo
-    for(int i=0; i<n; i++) { 
-        dist[i] = DBL_MAX;  // Infinito: vértice ainda não alcançável
-        pai[i] = -1;        // Sem predecessor
-    }
+    // Pré-processamento: nova geração na área de trabalho (sem varrer os n nós)
+    preparaContexto(s, c, crit, s->tipoFila);
+    double* dist = s->dist;  // dist[v] = menor distância de start até v
+    int* pai = s->pai;       // pai[v] = nó anterior no caminho ótimo
     
-    // Cria fila de prioridade para selecionar vértice com menor distância
+    // Fila de prioridade para selecionar vértice com menor distância
     // Essencial para eficiência: sem PQ seria O(V²)
-    priorityQueue pq = createPriorityQueue(n);
+    priorityQueue pq = s->pq;
+    tocaNo(s, start);
     dist[start] = 0;        // Distância ao próprio start é zero
     pq_insert(pq, start, 0); // Insere start na PQ com prioridade 0
     
@@ -123,60 +777,1691 @@ Lista findPath(Graph g, Node start, Node end, int crit, CalculaCustoAresta f) {
         // Extrai vértice com menor distância (greedy choice - Dijkstra's key insight)
         int u = pq_extract_min(pq);
         
-        // Otimizações de parada
+        // Entrada velha (radix/baldes não têm decrease-key): u já foi
+        // fechado e suas arestas não são reexaminadas
+        if (foiVisitado(s, u)) continue;
+        marcaVisitado(s, u);
+        
+        // Otimização de parada
         if (u == end) break;           // Encontramos o destino (early termination)
-        if (dist[u] == DBL_MAX) break; // Resto do grafo desconexo, impossível chegar
         
         // Relaxação de arestas: para cada vizinho v de u
         // Relaxar = tentar melhorar o caminho mais curto até v passando por u
-        Lista adjs = G->nodes[u].edges;  // Obtém arestas saindo de u
-        Iterador it = lista_iterador(adjs);
-        
-        while(iterador_tem_proximo(it)) {
-            EdgeImpl* e = (EdgeImpl*)iterador_proximo(it);
-            int v = e->dest;
-            
-            // Calcula o peso (distância/tempo/custo) da aresta u->v usando critério
-            double peso = f(e->info, crit);
+        // As arestas de u são contíguas em [off[u], off[u+1])
+        double du = dist[u];
+        for (int i = off[u]; i < off[u+1]; i++) {
+            int v = dest[i];
+            tocaNo(s, v);
             
             // RELAXAÇÃO: se encontramos caminho mais curto até v via u, atualiza
             // Condição: dist[u] + peso < dist[v]
-            if (dist[u] + peso < dist[v]) {
-                dist[v] = dist[u] + peso;  // Nova melhor distância
-                pai[v] = u;                 // Registra que v vem de u no caminho ótimo
-                pq_insert(pq, v, dist[v]); // Re-insere v na PQ com nova prioridade
+            double nd = du + peso[i];
+            if (nd < dist[v]) {
+                dist[v] = nd;              // Nova melhor distância
+                pai[v] = u;                // Registra que v vem de u no caminho ótimo
+                pq_decrease_key(pq, v, nd); // Insere v ou sobe sua prioridade no heap
             }
         }
-        iterador_destroi(it);
     }
     
     // ===== FASE 2: RECONSTRUÇÃO DO CAMINHO (Backtracking) =====
     // O array pai[] contém os predecessores, usamos para rastrear de end até start
-    Lista path = lista_cria();
+    // Se end não foi alcançado, nenhum caminho existe, path fica vazia
+    tocaNo(s, end);
+    return (dist[end] != DBL_MAX) ? reconstroiCaminho(G, pai, end, n) : lista_cria();
+}
+
+// ============================================================================
+// DIJKSTRA COM PESOS INTEIROS
+// ============================================================================
+// Mesmo algoritmo sobre a coluna uint32 do critério (setQuantizedWeights):
+// os pesos lidos e os rótulos ocupam metade da memória dos double, e as
+// comparações são inteiras. A busca não usa o dist double do contexto: uma
+// área de trabalho só de buscas inteiras nunca o aloca. O custo de um
+// caminho é a soma dos pesos arredondados, então o caminho é ótimo na
+// escala escolhida (empates podem diferir do double).
+// ============================================================================
+#define DIST_Q_INF UINT32_MAX
+
+static inline void tocaNoQ(SearchContextImpl* s, int v) {
+    if (s->geracao[v] == s->atual) return;
+    s->geracao[v] = s->atual;
+    s->distQ[v] = DIST_Q_INF;
+    s->pai[v] = -1;
+    s->visitado[v >> 6] &= ~(1ULL << (v & 63));
+}
+
+static Lista dijkstraQuantizado(GraphImpl* G, SearchContextImpl* s, Node start, Node end, int crit,
+                                unsigned* custo) {
+    CSRImpl* c = &G->csr;
+    int n = c->n;
+    const int* off = c->off;
+    const Node* dest = c->dest;
+    const uint32_t* peso = c->pesoQ[crit];
+    if (G->interno) { start = G->interno[start]; end = G->interno[end]; }
+    
+    // Baldes usam a largura dos pesos double: aqui vale o radix
+    reservaEstados(s, n);
+    if (s->capQ < s->cap) {
+        s->distQ = realloc(s->distQ, s->cap * sizeof(uint32_t));
+        s->capQ = s->cap;
+    }
+    preparaFila(s, c, crit, s->tipoFila == FILA_BALDES ? FILA_RADIX : s->tipoFila);
+    novaGeracao(s);
+    uint32_t* dist = s->distQ;
+    int* pai = s->pai;
+    priorityQueue pq = s->pq;
+    tocaNoQ(s, start);
+    dist[start] = 0;
+    pq_insert(pq, start, 0);
     
-    if (dist[end] != DBL_MAX) {  // Verifica se destino é alcançável
-        // Percorre backwards: end -> start seguindo o array pai[]
-        int curr = end;
-        int* temp = malloc(n * sizeof(int));  // Array temporário para reverter ordem
-        int count = 0;
+    while (!pq_empty(pq)) {
+        int u = pq_extract_min(pq);
+        if (foiVisitado(s, u)) continue;
+        marcaVisitado(s, u);
+        if (u == end) break;
         
-        // Coleta nós do caminho em ordem reversa (end -> start)
-        while(curr != -1) { 
-            temp[count++] = curr; 
-            curr = pai[curr];  // Salta para o predecessor
+        uint32_t du = dist[u];
+        for (int i = off[u]; i < off[u+1]; i++) {
+            if (peso[i] == PESO_Q_INF) continue;  // Removida ou fora da escala
+            int v = dest[i];
+            tocaNoQ(s, v);
+            uint64_t nd = (uint64_t)du + peso[i];  // 64 bits: a soma não estoura
+            if (nd < dist[v]) {
+                dist[v] = (uint32_t)nd;
+                pai[v] = u;
+                pq_decrease_key(pq, v, (double)nd);  // Exato: nd < 2^32
+            }
+        }
+    }
+    
+    tocaNoQ(s, end);
+    if (custo) *custo = dist[end];
+    return (dist[end] != DIST_Q_INF) ? reconstroiCaminho(G, pai, end, n) : lista_cria();
+}
+
+// ============================================================================
+// DIJKSTRA BIDIRECIONAL
+// ============================================================================
+// Uma busca para frente a partir de start (CSR direto) e outra para trás a
+// partir de end (CSR reverso), alternadas. `mu` guarda o melhor caminho
+// completo já visto (dF[v] + dB[v]); quando topoF + topoB >= mu nenhum
+// caminho melhor pode existir e a busca para. Cada lado cobre um disco de
+// raio ~d/2, cerca de metade dos nós de uma busca unidirecional.
+// ============================================================================
+// Lado de trás: área de trabalho própria, criada no primeiro uso e presa à
+// da frente (mesma fila escolhida em setSearchQueue)
+static SearchContextImpl* contextoTras(SearchContextImpl* s) {
+    if (!s->tras) s->tras = createSearchContext();
+    s->tras->tipoFila = s->tipoFila;
+    return s->tras;
+}
+
+// dist[v] da consulta atual, sem tocar v (DBL_MAX se não alcançado)
+static inline double distAtual(const SearchContextImpl* s, int v) {
+    return s->geracao[v] == s->atual ? s->dist[v] : DBL_MAX;
+}
+
+static Lista dijkstraBidirecional(GraphImpl* G, SearchContextImpl* sF, Node start, Node end, int crit) {
+    CSRImpl* c = &G->csr;
+    garanteReverso(c);
+    if (G->interno) { start = G->interno[start]; end = G->interno[end]; }
+    const double* peso = c->peso[crit];
+    
+    // Índice 0 = frente, 1 = trás. pai[1][v] é o próximo nó de v rumo a end.
+    // Nova geração nas duas áreas: preparo proporcional aos nós tocados.
+    // Cada lado tem chaves monótonas, então o radix também serve; os baldes
+    // caem para o radix como nas outras buscas sem a largura do critério.
+    SearchContextImpl* s[2] = { sF, contextoTras(sF) };
+    int fila = sF->tipoFila == FILA_BALDES ? FILA_RADIX : sF->tipoFila;
+    preparaContexto(s[0], c, crit, fila);
+    preparaContexto(s[1], c, crit, fila);
+    tocaNo(s[0], start);
+    tocaNo(s[1], end);
+    s[0]->dist[start] = 0; pq_insert(s[0]->pq, start, 0);
+    s[1]->dist[end] = 0;   pq_insert(s[1]->pq, end, 0);
+    
+    double mu = (start == end) ? 0 : DBL_MAX;
+    int meio = (start == end) ? start : -1;
+    int lado = 0;
+    
+    while (!pq_empty(s[0]->pq) && !pq_empty(s[1]->pq)) {
+        // Critério de parada padrão: nenhum caminho pode ser menor que mu
+        if (pq_min_prio(s[0]->pq) + pq_min_prio(s[1]->pq) >= mu) break;
+        
+        SearchContextImpl* sl = s[lado];
+        int u = pq_extract_min(sl->pq);
+        if (!foiVisitado(sl, u)) {
+            marcaVisitado(sl, u);
+            double du = sl->dist[u];
+            // Frente percorre off/dest; trás percorre roff/rorig (peso via rpos)
+            const int* off = lado == 0 ? c->off : c->roff;
+            for (int i = off[u]; i < off[u+1]; i++) {
+                int v = lado == 0 ? c->dest[i] : c->rorig[i];
+                double nd = du + peso[lado == 0 ? i : c->rpos[i]];
+                tocaNo(sl, v);
+                if (nd < sl->dist[v]) {
+                    sl->dist[v] = nd;
+                    sl->pai[v] = u;
+                    pq_decrease_key(sl->pq, v, nd);
+                }
+                // v já foi alcançado pelo outro lado: candidato a caminho
+                double outro = distAtual(s[1 - lado], v);
+                if (outro != DBL_MAX && sl->dist[v] + outro < mu) {
+                    mu = sl->dist[v] + outro;
+                    meio = v;
+                }
+            }
         }
+        lado = 1 - lado;  // Alterna as direções
+    }
+    
+    if (meio == -1) return lista_cria();
+    // start .. meio pela árvore da frente, meio .. end pela de trás
+    Lista path = reconstroiCaminho(G, s[0]->pai, meio, c->n);
+    for (int v = s[1]->pai[meio]; v != -1; v = s[1]->pai[v]) {
+        int e = G->externo ? G->externo[v] : v;
+        lista_insere(path, (void*)(intptr_t)e);
+    }
+    return path;
+}
+
+// ============================================================================
+// A* COM HEURÍSTICA EUCLIDIANA
+// ============================================================================
+// h(v) = escala * distância euclidiana(v, end). A escala é o menor valor de
+// peso/comprimento_euclidiano entre todas as arestas. Para CRITERIO_DISTANCIA
+// com comprimentos reais isso é ~1 (distância em linha reta); para
+// CRITERIO_TEMPO é ~1/velocidade_máxima. Assim h(u) <= w(u,v) + h(v) para
+// toda aresta (heurística consistente) e o caminho continua ótimo.
+// ============================================================================
+static double escalaHeuristica(CSRImpl* c, int crit) {
+    if (c->escalaValida[crit]) return c->escalaH[crit];
+    double escala = DBL_MAX;
+    const double* peso = c->peso[crit];
+    for (int u = 0; u < c->n; u++) {
+        for (int i = c->off[u]; i < c->off[u+1]; i++) {
+            int v = c->dest[i];
+            double dx = c->cx[u] - c->cx[v], dy = c->cy[u] - c->cy[v];
+            double comp = sqrt(dx*dx + dy*dy);
+            if (comp <= 0 || peso[i] == INFINITY) continue;
+            double r = peso[i] / comp;
+            if (r < escala) escala = r;
+        }
+    }
+    if (escala == DBL_MAX) escala = 0;  // Sem arestas úteis: vira Dijkstra
+    // Margem contra arredondamento, para não quebrar a consistência
+    c->escalaH[crit] = escala * (1 - 1e-9);
+    c->escalaValida[crit] = true;
+    return c->escalaH[crit];
+}
+
+// `h` == NULL usa a heurística euclidiana; senão h(v, end, ctx) com ids externos
+static Lista astarCSR(GraphImpl* G, SearchContextImpl* s, Node start, Node end, int crit,
+                      Heuristica h, void* ctx) {
+    CSRImpl* c = &G->csr;
+    int n = c->n;
+    Node fim = end;  // Id externo, para `h`
+    if (G->interno) { start = G->interno[start]; end = G->interno[end]; }
+    const int* off = c->off;
+    const Node* dest = c->dest;
+    const double* peso = c->peso[crit];
+    const double* cx = c->cx;
+    const double* cy = c->cy;
+    double escala = h ? 0 : escalaHeuristica(c, crit);
+    double tx = cx[end], ty = cy[end];
+    
+    // Com heurística as chaves f = g + h não respeitam a largura dos baldes
+    preparaContexto(s, c, crit, s->tipoFila == FILA_BALDES ? FILA_RADIX : s->tipoFila);
+    double* dist = s->dist;  // g(v): custo real desde start
+    int* pai = s->pai;
+    priorityQueue pq = s->pq;
+    tocaNo(s, start);
+    dist[start] = 0;
+    pq_insert(pq, start, 0);
+    
+    while (!pq_empty(pq)) {
+        int u = pq_extract_min(pq);    // Menor f(u) = g(u) + h(u)
+        if (foiVisitado(s, u)) continue; // Entrada velha ou heurística inconsistente
+        marcaVisitado(s, u);
+        if (u == end) break;
         
-        // Insere na lista em ordem correta: start -> end
-        for(int i=count-1; i>=0; i--) 
-            lista_insere(path, (void*)(intptr_t)temp[i]);
+        double du = dist[u];
+        for (int i = off[u]; i < off[u+1]; i++) {
+            int v = dest[i];
+            tocaNo(s, v);
+            double nd = du + peso[i];
+            if (nd < dist[v]) {
+                dist[v] = nd;
+                pai[v] = u;
+                double hv;
+                if (h) {
+                    hv = h(G->externo ? G->externo[v] : v, fim, ctx);
+                    if (hv == INFINITY) continue;  // end é inalcançável a partir de v
+                } else {
+                    double dx = cx[v] - tx, dy = cy[v] - ty;
+                    hv = escala * sqrt(dx*dx + dy*dy);
+                }
+                pq_decrease_key(pq, v, nd + hv);
+            }
+        }
+    }
+    
+    tocaNo(s, end);
+    return (dist[end] != DBL_MAX) ? reconstroiCaminho(G, pai, end, n) : lista_cria();
+}
+
+static Lista buscaModo(GraphImpl* G, SearchContextImpl* s, Node start, Node end, int crit, int modo) {
+    if (modo == BUSCA_BIDIRECIONAL) return dijkstraBidirecional(G, s, start, end, crit);
+    if (modo == BUSCA_ASTAR) return astarCSR(G, s, start, end, crit, NULL, NULL);
+    return dijkstraCSR(G, s, start, end, crit);
+}
+
+Lista findPathMode(Graph g, Node start, Node end, int crit, CalculaCustoAresta f, int modo) {
+    GraphImpl* G = (GraphImpl*)g;
+    // Colunas de peso são reaproveitadas enquanto o grafo e `f` não mudarem
+    if (!G->csr.valido || G->csr.f != f) freezeGraph(g, f);
+    return buscaModo(G, contextoPadrao(G), start, end, crit, modo);
+}
+
+Lista findPathAStar(Graph g, Node start, Node end, int crit, CalculaCustoAresta f,
+                    Heuristica h, void* ctx) {
+    GraphImpl* G = (GraphImpl*)g;
+    if (!G->csr.valido || G->csr.f != f) freezeGraph(g, f);
+    return astarCSR(G, contextoPadrao(G), start, end, crit, h, ctx);
+}
+
+Lista findPath(Graph g, Node start, Node end, int crit, CalculaCustoAresta f) {
+    return findPathMode(g, start, end, crit, f, BUSCA_DIJKSTRA);
+}
+
+void setQuantizedWeights(Graph g, int crit, double escala) {
+    GraphImpl* G = (GraphImpl*)g;
+    CSRImpl* c = &G->csr;
+    G->escalaQ[crit] = escala > 0 ? escala : 0;
+    if (!G->escalaQ[crit]) {
+        free(c->pesoQ[crit]);
+        c->pesoQ[crit] = NULL;
+    } else if (c->valido) {
+        montaPesosQ(G, crit);
+    }
+}
+
+Lista findPathQuantized(Graph g, Node start, Node end, int crit, CalculaCustoAresta f, unsigned* custo) {
+    GraphImpl* G = (GraphImpl*)g;
+    if (!G->csr.valido || G->csr.f != f) freezeGraph(g, f);
+    if (!G->csr.pesoQ[crit]) {
+        // Critério sem pesos inteiros: busca double comum
+        if (custo) *custo = UINT32_MAX;
+        return dijkstraCSR(G, contextoPadrao(G), start, end, crit);
+    }
+    return dijkstraQuantizado(G, contextoPadrao(G), start, end, crit, custo);
+}
+
+// ============================================================================
+// PERFIS DE TEMPO E DIJKSTRA DEPENDENTE DO HORÁRIO
+// ============================================================================
+// Aresta com perfil: tempo(t) = base * fator(t), base = peso de
+// CRITERIO_TEMPO. A busca propaga horários de chegada em vez de custos:
+// chegada(v) = chegada(u) + tempo_uv(chegada(u)). Com FIFO (sair mais tarde
+// nunca faz chegar mais cedo: base * inclinação >= -1) o Dijkstra continua
+// correto, porque esperar num nó nunca ajuda.
+// ============================================================================
+static double inclinacaoMinima(const double* t, const double* v, int n) {
+    if (n < 2) return 0;
+    double menor = DBL_MAX;
+    for (int i = 0; i < n; i++) {
+        int j = (i + 1) % n;
+        double dt = (j > i) ? t[j] - t[i] : t[j] + PERIODO_PERFIL - t[i];
+        double incl = (v[j] - v[i]) / dt;
+        if (incl < menor) menor = incl;
+    }
+    return menor;
+}
+
+// FNV-1a sobre os bytes dos pontos: perfis iguais (memcmp) têm o mesmo hash
+static uint64_t hashPerfil(const double* horarios, const double* fatores, int n) {
+    uint64_t h = 1469598103934665603ULL ^ (uint64_t)n;
+    const double* v[2] = { horarios, fatores };
+    for (int k = 0; k < 2; k++) {
+        const unsigned char* b = (const unsigned char*)v[k];
+        for (size_t i = 0; i < n * sizeof(double); i++) {
+            h ^= b[i];
+            h *= 1099511628211ULL;
+        }
+    }
+    return h;
+}
+
+// Dobra os baldes do índice de perfis e reencadeia todos
+static void cresceBaldesPerfil(GraphImpl* G) {
+    free(G->baldesPerfil);
+    G->nBaldesPerfil = G->nBaldesPerfil ? 2*G->nBaldesPerfil : 16;
+    G->baldesPerfil = malloc(G->nBaldesPerfil * sizeof(int));
+    for (int b = 0; b < G->nBaldesPerfil; b++) G->baldesPerfil[b] = -1;
+    for (int p = 0; p < G->nPerfis; p++) {
+        int b = (int)(G->perfis[p].hash & (uint64_t)(G->nBaldesPerfil - 1));
+        G->perfis[p].prox = G->baldesPerfil[b];
+        G->baldesPerfil[b] = p;
+    }
+}
+
+int createTimeProfile(Graph g, const double* horarios, const double* fatores, int n) {
+    GraphImpl* G = (GraphImpl*)g;
+    if (n < 1) return -1;
+    for (int i = 0; i < n; i++) {
+        if (!(horarios[i] >= 0 && horarios[i] < PERIODO_PERFIL) || !(fatores[i] > 0)) return -1;
+        if (i > 0 && horarios[i] <= horarios[i-1]) return -1;
+    }
+    // Perfil igual já no pool: reaproveita
+    uint64_t h = hashPerfil(horarios, fatores, n);
+    if (G->nBaldesPerfil) {
+        for (int p = G->baldesPerfil[h & (uint64_t)(G->nBaldesPerfil - 1)]; p != -1; p = G->perfis[p].prox) {
+            PerfilImpl* q = &G->perfis[p];
+            if (q->hash == h && q->n == n && memcmp(G->ptT + q->ini, horarios, n * sizeof(double)) == 0
+                                          && memcmp(G->ptF + q->ini, fatores, n * sizeof(double)) == 0)
+                return p;
+        }
+    }
+    if (G->nPontos + n > G->capPontos) {
+        int cap = G->capPontos ? G->capPontos : 64;
+        while (cap < G->nPontos + n) cap *= 2;
+        G->ptT = realloc(G->ptT, cap * sizeof(double));
+        G->ptF = realloc(G->ptF, cap * sizeof(double));
+        G->capPontos = cap;
+    }
+    if (G->nPerfis == G->capPerfis) {
+        G->capPerfis = G->capPerfis ? 2*G->capPerfis : 8;
+        G->perfis = realloc(G->perfis, G->capPerfis * sizeof(PerfilImpl));
+    }
+    PerfilImpl* q = &G->perfis[G->nPerfis];
+    q->ini = G->nPontos;
+    q->n = n;
+    memcpy(G->ptT + q->ini, horarios, n * sizeof(double));
+    memcpy(G->ptF + q->ini, fatores, n * sizeof(double));
+    q->inclMin = inclinacaoMinima(horarios, fatores, n);
+    q->hash = h;
+    G->nPontos += n;
+    int p = G->nPerfis++;
+    if (G->nPerfis > G->nBaldesPerfil) {
+        cresceBaldesPerfil(G);  // Já encadeia o perfil novo
+    } else {
+        int b = (int)(h & (uint64_t)(G->nBaldesPerfil - 1));
+        q->prox = G->baldesPerfil[b];
+        G->baldesPerfil[b] = p;
+    }
+    return p;
+}
+
+int getNumTimeProfiles(Graph g) { return ((GraphImpl*)g)->nPerfis; }
+
+// Fator do perfil no horário t (qualquer t: é reduzido ao período)
+static double fatorPerfil(const GraphImpl* G, int p, double t) {
+    const PerfilImpl* q = &G->perfis[p];
+    const double* pt = G->ptT + q->ini;
+    const double* pf = G->ptF + q->ini;
+    int n = q->n;
+    if (n == 1) return pf[0];
+    t = fmod(t, PERIODO_PERFIL);
+    if (t < 0) t += PERIODO_PERFIL;
+    double t0, t1, f0, f1;
+    if (t < pt[0] || t >= pt[n-1]) {
+        // Trecho que cruza a meia-noite: do último ponto ao primeiro
+        t0 = pt[n-1]; f0 = pf[n-1];
+        t1 = pt[0] + PERIODO_PERFIL; f1 = pf[0];
+        if (t < pt[0]) t += PERIODO_PERFIL;
+    } else {
+        int lo = 0, hi = n - 1;  // pt[lo] <= t < pt[hi]
+        while (hi - lo > 1) {
+            int meio = (lo + hi) / 2;
+            if (pt[meio] <= t) lo = meio; else hi = meio;
+        }
+        t0 = pt[lo]; f0 = pf[lo];
+        t1 = pt[hi]; f1 = pf[hi];
+    }
+    return f0 + (f1 - f0) * (t - t0) / (t1 - t0);
+}
+
+bool setEdgeProfile(Graph g, Edge e, int perfil, CalculaCustoAresta f) {
+    GraphImpl* G = (GraphImpl*)g;
+    EdgeImpl* a = (EdgeImpl*)e;
+    if (perfil >= G->nPerfis) return false;
+    if (perfil >= 0 && f(a->info, CRITERIO_TEMPO) * G->perfis[perfil].inclMin < -1) return false;
+    a->perfil = perfil < 0 ? -1 : perfil;
+    CSRImpl* c = &G->csr;
+    if (c->valido && c->perfil && a->pos >= 0) c->perfil[a->pos] = a->perfil;
+    G->versao++;
+    return true;
+}
+
+// Coluna de perfis do snapshot a partir das arestas
+static void garantePerfis(GraphImpl* G) {
+    CSRImpl* c = &G->csr;
+    if (c->perfil) return;
+    c->perfil = malloc((c->m > 0 ? c->m : 1) * sizeof(int));
+    for (int i = 0; i < c->m; i++) c->perfil[i] = -1;
+    for (int u = 0; u < c->n; u++)
+        for (EdgeImpl* e = G->nodes[u].prim; e; e = e->prox)
+            if (e->pos >= 0) c->perfil[e->pos] = e->perfil;
+}
+
+static Lista dijkstraTD(GraphImpl* G, SearchContextImpl* s, Node start, Node end, double partida,
+                        double* chegada) {
+    CSRImpl* c = &G->csr;
+    int n = c->n;
+    const int* off = c->off;
+    const Node* dest = c->dest;
+    const double* base = c->peso[CRITERIO_TEMPO];
+    const int* perfil = c->perfil;
+    if (G->interno) { start = G->interno[start]; end = G->interno[end]; }
+    
+    // Chaves são horários (crescem com FIFO); a largura dos baldes não vale
+    preparaContexto(s, c, CRITERIO_TEMPO, s->tipoFila == FILA_BALDES ? FILA_RADIX : s->tipoFila);
+    double* dist = s->dist;  // Horário de chegada
+    int* pai = s->pai;
+    priorityQueue pq = s->pq;
+    tocaNo(s, start);
+    dist[start] = partida;
+    pq_insert(pq, start, partida);
+    
+    while (!pq_empty(pq)) {
+        int u = pq_extract_min(pq);
+        if (foiVisitado(s, u)) continue;
+        marcaVisitado(s, u);
+        if (u == end) break;
         
-        free(temp);
+        double du = dist[u];
+        for (int i = off[u]; i < off[u+1]; i++) {
+            double w = base[i];
+            int p = perfil[i];
+            // Perfil que deixou de ser FIFO (base aumentou via setEdgeAttr)
+            // é ignorado: o tempo base mantém a busca correta
+            if (p >= 0 && w * G->perfis[p].inclMin >= -1) w *= fatorPerfil(G, p, du);
+            int v = dest[i];
+            tocaNo(s, v);
+            double nd = du + w;
+            if (nd < dist[v]) {
+                dist[v] = nd;
+                pai[v] = u;
+                pq_decrease_key(pq, v, nd);
+            }
+        }
     }
-    // Se dist[end] == DBL_MAX, nenhum caminho existe, path fica vazia
     
-    // Libera estruturas auxiliares
-    free(dist); 
-    free(pai); 
+    tocaNo(s, end);
+    if (chegada) *chegada = dist[end];
+    return (dist[end] != DBL_MAX) ? reconstroiCaminho(G, pai, end, n) : lista_cria();
+}
+
+Lista findPathTD(Graph g, Node start, Node end, CalculaCustoAresta f, double partida, double* chegada) {
+    GraphImpl* G = (GraphImpl*)g;
+    if (!G->csr.valido || G->csr.f != f) freezeGraph(g, f);
+    garantePerfis(G);
+    return dijkstraTD(G, contextoPadrao(G), start, end, partida, chegada);
+}
+
+// ============================================================================
+// CONVERSÕES E BUSCA POR ARESTAS
+// ============================================================================
+// Restrições de conversão dependem da aresta por onde se chegou ao nó, então
+// o estado da busca é a aresta (posição no CSR), não o nó: é o Dijkstra sobre
+// o grafo de linhas, sem montá-lo. Os sucessores do estado i (u -> v) são as
+// arestas de saída de v, com o custo da conversão somado. Memória: dist/pai
+// por aresta mais a tabela de conversões, que só guarda os pares definidos.
+//
+// Custos de conversão são tempo: entram na busca por CRITERIO_TEMPO. Nos
+// outros critérios só as proibições valem.
+// ============================================================================
+// Espalha o par de arestas pelos bits altos, como baldeDe
+static unsigned baldeConversao(const EdgeImpl* a, const EdgeImpl* b, int nBaldes) {
+    uint64_t k = (uint64_t)(uintptr_t)a * 0x9E3779B97F4A7C15ULL ^ (uint64_t)(uintptr_t)b;
+    k *= 0x9E3779B97F4A7C15ULL;
+    return (unsigned)(k >> 32) & (unsigned)(nBaldes - 1);
+}
+
+// Dobra os baldes do índice de conversões e reencadeia todas
+static void cresceBaldesConversao(GraphImpl* G) {
+    free(G->baldesConversao);
+    G->nBaldesConversao = G->nBaldesConversao ? 2*G->nBaldesConversao : 16;
+    G->baldesConversao = malloc(G->nBaldesConversao * sizeof(int));
+    for (int b = 0; b < G->nBaldesConversao; b++) G->baldesConversao[b] = -1;
+    for (int k = 0; k < G->nConversoes; k++) {
+        ConversaoImpl* cv = &G->conversoes[k];
+        unsigned b = baldeConversao(cv->de, cv->para, G->nBaldesConversao);
+        cv->prox = G->baldesConversao[b];
+        G->baldesConversao[b] = k;
+    }
+}
+
+bool setTurnCost(Graph g, Edge de, Edge para, double custo) {
+    GraphImpl* G = (GraphImpl*)g;
+    EdgeImpl* a = (EdgeImpl*)de;
+    EdgeImpl* b = (EdgeImpl*)para;
+    if (!a || !b || a->dest != b->orig) return false;
+    if (custo < 0) custo = INFINITY;
+    G->versao++;
+    
+    // Par já definido: troca o custo (e a entrada da tabela, se montada)
+    if (G->nBaldesConversao) {
+        unsigned bl = baldeConversao(a, b, G->nBaldesConversao);
+        for (int k = G->baldesConversao[bl]; k != -1; k = G->conversoes[k].prox) {
+            ConversaoImpl* cv = &G->conversoes[k];
+            if (cv->de != a || cv->para != b) continue;
+            cv->custo = custo;
+            CSRImpl* c = &G->csr;
+            if (c->conversoesValidas && a->pos >= 0 && b->pos >= 0)
+                for (int q = c->toff[a->pos]; q < c->toff[a->pos + 1]; q++)
+                    if (c->tpara[q] == b->pos) c->tcusto[q] = custo;
+            return true;
+        }
+    }
+    
+    if (G->nConversoes == G->capConversoes) {
+        G->capConversoes = G->capConversoes ? 2*G->capConversoes : 16;
+        G->conversoes = realloc(G->conversoes, G->capConversoes * sizeof(ConversaoImpl));
+    }
+    int k = G->nConversoes++;
+    G->conversoes[k] = (ConversaoImpl){ a, b, custo, -1 };
+    if (G->nConversoes > G->nBaldesConversao) {
+        cresceBaldesConversao(G);  // Já encadeia a nova
+    } else {
+        unsigned bl = baldeConversao(a, b, G->nBaldesConversao);
+        G->conversoes[k].prox = G->baldesConversao[bl];
+        G->baldesConversao[bl] = k;
+    }
+    G->csr.conversoesValidas = false;
+    return true;
+}
+
+void setUTurnCost(Graph g, double custo) {
+    GraphImpl* G = (GraphImpl*)g;
+    G->custoRetorno = custo < 0 ? INFINITY : custo;
+    G->versao++;
+}
+
+// Agrupa as conversões pela aresta de chegada (contagem)
+static void garanteConversoes(GraphImpl* G) {
+    CSRImpl* c = &G->csr;
+    if (c->conversoesValidas) return;
+    int m = c->m;
+    if (!c->eorig) {
+        c->eorig = malloc((m > 0 ? m : 1) * sizeof(int));
+        for (int u = 0; u < c->n; u++)
+            for (int i = c->off[u]; i < c->off[u+1]; i++) c->eorig[i] = u;
+    }
+    free(c->toff); free(c->tpara); free(c->tcusto);
+    c->toff = calloc(m + 1, sizeof(int));
+    int t = G->nConversoes;
+    for (int k = 0; k < t; k++) {
+        ConversaoImpl* cv = &G->conversoes[k];
+        if (cv->de->pos >= 0 && cv->para->pos >= 0) c->toff[cv->de->pos + 1]++;
+    }
+    for (int i = 0; i < m; i++) c->toff[i+1] += c->toff[i];
+    c->tpara = malloc((c->toff[m] > 0 ? c->toff[m] : 1) * sizeof(int));
+    c->tcusto = malloc((c->toff[m] > 0 ? c->toff[m] : 1) * sizeof(double));
+    int* prox = malloc((m > 0 ? m : 1) * sizeof(int));
+    memcpy(prox, c->toff, m * sizeof(int));
+    for (int k = 0; k < t; k++) {
+        ConversaoImpl* cv = &G->conversoes[k];
+        if (cv->de->pos < 0 || cv->para->pos < 0) continue;
+        int q = prox[cv->de->pos]++;
+        c->tpara[q] = cv->para->pos;
+        c->tcusto[q] = cv->custo;
+    }
+    free(prox);
+    c->conversoesValidas = true;
+}
+
+// Custo da conversão i -> j (j sai do destino de i)
+static inline double custoConversao(const GraphImpl* G, const CSRImpl* c, int i, int j) {
+    for (int q = c->toff[i]; q < c->toff[i+1]; q++)
+        if (c->tpara[q] == j) return c->tcusto[q];
+    return (c->dest[j] == c->eorig[i]) ? G->custoRetorno : 0;
+}
+
+static Lista dijkstraArestas(GraphImpl* G, SearchContextImpl* s, Node start, Node end, int crit,
+                             double* custo) {
+    CSRImpl* c = &G->csr;
+    const int* off = c->off;
+    const Node* dest = c->dest;
+    const double* peso = c->peso[crit];
+    bool somaConversao = crit == CRITERIO_TEMPO;
+    if (G->interno) { start = G->interno[start]; end = G->interno[end]; }
+    Lista path = lista_cria();
+    if (custo) *custo = DBL_MAX;
+    if (start == end) {
+        if (custo) *custo = 0;
+        lista_insere(path, (void*)(intptr_t)(G->externo ? G->externo[start] : start));
+        return path;
+    }
+    
+    reservaContexto(s, c->m);
+    preparaContexto(s, c, crit, s->tipoFila == FILA_BALDES ? FILA_RADIX : s->tipoFila);
+    double* dist = s->dist;  // Por aresta: custo até o fim da aresta
+    int* pai = s->pai;       // Aresta anterior (-1 = sai de start)
+    priorityQueue pq = s->pq;
+    for (int i = off[start]; i < off[start+1]; i++) {
+        if (peso[i] == INFINITY) continue;
+        tocaNo(s, i);
+        if (peso[i] < dist[i]) {
+            dist[i] = peso[i];
+            pai[i] = -1;
+            pq_decrease_key(pq, i, peso[i]);
+        }
+    }
+    
+    int fim = -1;
+    while (!pq_empty(pq)) {
+        int i = pq_extract_min(pq);
+        if (foiVisitado(s, i)) continue;
+        marcaVisitado(s, i);
+        int v = dest[i];
+        if (v == end) { fim = i; break; }  // Conversões só pesam ao seguir adiante
+        
+        double di = dist[i];
+        for (int j = off[v]; j < off[v+1]; j++) {
+            double cv = custoConversao(G, c, i, j);
+            if (cv == INFINITY || peso[j] == INFINITY) continue;
+            double nd = di + peso[j] + (somaConversao ? cv : 0);
+            tocaNo(s, j);
+            if (nd < dist[j]) {
+                dist[j] = nd;
+                pai[j] = i;
+                pq_decrease_key(pq, j, nd);
+            }
+        }
+    }
+    
+    if (fim == -1) return path;
+    if (custo) *custo = dist[fim];
+    int count = 0;
+    for (int i = fim; i != -1; i = pai[i]) count++;
+    int* nos = malloc((count + 1) * sizeof(int));
+    int k = count;
+    for (int i = fim; i != -1; i = pai[i]) nos[k--] = dest[i];
+    nos[0] = start;
+    for (k = 0; k <= count; k++)
+        lista_insere(path, (void*)(intptr_t)(G->externo ? G->externo[nos[k]] : nos[k]));
+    free(nos);
+    return path;
+}
+
+Lista findPathTurns(Graph g, Node start, Node end, int crit, CalculaCustoAresta f, double* custo) {
+    GraphImpl* G = (GraphImpl*)g;
+    if (!G->csr.valido || G->csr.f != f) freezeGraph(g, f);
+    garanteConversoes(G);
+    return dijkstraArestas(G, contextoPadrao(G), start, end, crit, custo);
+}
+
+int getNumTurns(Graph g) { return ((GraphImpl*)g)->nConversoes; }
+
+// ============================================================================
+// ROTAS DE PARETO (DISTÂNCIA x TEMPO)
+// ============================================================================
+// Busca por rótulos (Martins): cada rótulo é um caminho parcial (distância,
+// tempo) até um nó. A fila ordena por distância, de modo que os rótulos de
+// um nó são fechados com distância crescente; um rótulo novo só não é
+// dominado se tiver tempo menor que o de todos os já fechados no nó. Com
+// dois critérios a dominância fica O(1): basta o menor tempo fechado.
+//
+// Os rótulos ficam num vetor contíguo, ligados ao anterior por índice (sem
+// malloc por rótulo). Na área de trabalho, dist[v] é o menor tempo fechado
+// em v e pai[v] + 1 quantos rótulos v já fechou. Rótulos com tempo não
+// menor que a melhor rota já encontrada também são descartados.
+// ============================================================================
+typedef struct {
+    double d, t;  // Distância e tempo acumulados
+    int no;       // Interno
+    int ant;      // Rótulo anterior (-1 na origem)
+} Rotulo;
+
+static int novoRotulo(Rotulo** v, int* n, int* cap, Rotulo r) {
+    if (*n == *cap) {
+        *cap = *cap ? 2 * *cap : 256;
+        *v = realloc(*v, *cap * sizeof(Rotulo));
+    }
+    (*v)[*n] = r;
+    return (*n)++;
+}
+
+static RotaPareto* montaRotaPareto(GraphImpl* G, const Rotulo* rot, int r) {
+    RotaPareto* rota = malloc(sizeof(RotaPareto));
+    rota->distancia = rot[r].d;
+    rota->tempo = rot[r].t;
+    int count = 0;
+    for (int k = r; k != -1; k = rot[k].ant) count++;
+    int* nos = malloc(count * sizeof(int));
+    for (int k = r, i = count - 1; k != -1; k = rot[k].ant) nos[i--] = rot[k].no;
+    rota->caminho = lista_cria();
+    for (int i = 0; i < count; i++)
+        lista_insere(rota->caminho, (void*)(intptr_t)(G->externo ? G->externo[nos[i]] : nos[i]));
+    free(nos);
+    return rota;
+}
+
+Lista findPathPareto(Graph g, Node start, Node end, CalculaCustoAresta f, int maxRotulos) {
+    GraphImpl* G = (GraphImpl*)g;
+    if (!G->csr.valido || G->csr.f != f) freezeGraph(g, f);
+    CSRImpl* c = &G->csr;
+    const int* off = c->off;
+    const Node* dest = c->dest;
+    const double* pd = c->peso[CRITERIO_DISTANCIA];
+    const double* pt = c->peso[CRITERIO_TEMPO];
+    if (maxRotulos <= 0) maxRotulos = PARETO_ROTULOS_PADRAO;
+    if (G->interno) { start = G->interno[start]; end = G->interno[end]; }
+    
+    // Só dist/pai do contexto: a fila dele (escolhida pelo usuário) fica
+    // intacta, a busca usa a sua própria fila de rótulos
+    SearchContextImpl* s = contextoPadrao(G);
+    reservaContexto(s, c->n);
+    novaGeracao(s);
+    double* melhorT = s->dist;
+    int* fechados = s->pai;
+    Rotulo* rot = NULL;
+    int nRot = 0, capRot = 0;
+    priorityQueue pq = createPriorityQueue(64);  // Com repetidos: item = rótulo
+    tocaNo(s, start);
+    tocaNo(s, end);
+    pq_insert(pq, novoRotulo(&rot, &nRot, &capRot, (Rotulo){ 0, 0, start, -1 }), 0);
+    
+    // Fronteira no destino, em ordem de distância crescente
+    int* fronteira = NULL;
+    int nFront = 0, capFront = 0;
+    while (!pq_empty(pq)) {
+        int r = pq_extract_min(pq);
+        Rotulo l = rot[r];
+        int u = l.no;
+        if (l.t >= melhorT[u] || l.t >= melhorT[end] || fechados[u] + 1 >= maxRotulos) continue;
+        melhorT[u] = l.t;
+        fechados[u]++;
+        if (u == end) {
+            if (nFront == capFront) {
+                capFront = capFront ? 2*capFront : 16;
+                fronteira = realloc(fronteira, capFront * sizeof(int));
+            }
+            // Mesma distância e tempo menor: a anterior era dominada
+            if (nFront > 0 && rot[fronteira[nFront-1]].d == l.d) fronteira[nFront-1] = r;
+            else fronteira[nFront++] = r;
+            continue;
+        }
+        for (int i = off[u]; i < off[u+1]; i++) {
+            if (pd[i] == INFINITY || pt[i] == INFINITY) continue;
+            int v = dest[i];
+            tocaNo(s, v);
+            double nt = l.t + pt[i];
+            if (nt >= melhorT[v] || nt >= melhorT[end] || fechados[v] + 1 >= maxRotulos) continue;
+            int k = novoRotulo(&rot, &nRot, &capRot, (Rotulo){ l.d + pd[i], nt, v, r });
+            pq_insert(pq, k, rot[k].d);
+        }
+    }
     pq_destroy(pq);
+    
+    Lista rotas = lista_cria();
+    for (int i = 0; i < nFront; i++) lista_insere(rotas, montaRotaPareto(G, rot, fronteira[i]));
+    free(fronteira);
+    free(rot);
+    return rotas;
+}
+
+void destroyParetoRoutes(Lista rotas) {
+    while (!lista_vazia(rotas)) {
+        RotaPareto* r = lista_remove_primeiro(rotas);
+        lista_libera(r->caminho);
+        free(r);
+    }
+    lista_libera(rotas);
+}
+
+// ============================================================================
+// ISÓCRONAS (ALCANCE COM ORÇAMENTO)
+// ============================================================================
+// Dijkstra de um para todos que para quando o menor custo na fila passa do
+// orçamento. O resultado e a área de trabalho ficam no objeto Isochrone e
+// são reaproveitados: depois da primeira consulta, nada de O(V) é alocado
+// ou zerado (a área de trabalho reinicia só os nós tocados).
+//
+// Aresta de fronteira: sai de um nó alcançado u e chega em v que não foi
+// alcançado, com d[u] <= orçamento < d[u] + w. `alcance` é a fração da
+// aresta coberta a partir de u. No modo reverso (quem chega em src) a busca
+// anda pelo CSR reverso e a fração é medida a partir da ponta alcançada.
+// ============================================================================
+typedef struct {
+    SearchContext ctx;
+    Node* nos; double* custos; int nNos, capNos;
+    Node* fu; Node* fv; double* falc; int nFront, capFront;
+} IsochroneImpl;
+
+Isochrone createIsochrone(void) {
+    IsochroneImpl* r = calloc(1, sizeof(IsochroneImpl));
+    r->ctx = createSearchContext();
+    return r;
+}
+
+static void isoInsereNo(IsochroneImpl* r, Node v, double custo) {
+    if (r->nNos == r->capNos) {
+        r->capNos = r->capNos ? 2*r->capNos : 64;
+        r->nos = realloc(r->nos, r->capNos * sizeof(Node));
+        r->custos = realloc(r->custos, r->capNos * sizeof(double));
+    }
+    r->nos[r->nNos] = v;
+    r->custos[r->nNos++] = custo;
+}
+
+static void isoInsereFronteira(IsochroneImpl* r, Node u, Node v, double alcance) {
+    if (r->nFront == r->capFront) {
+        r->capFront = r->capFront ? 2*r->capFront : 64;
+        r->fu = realloc(r->fu, r->capFront * sizeof(Node));
+        r->fv = realloc(r->fv, r->capFront * sizeof(Node));
+        r->falc = realloc(r->falc, r->capFront * sizeof(double));
+    }
+    r->fu[r->nFront] = u;
+    r->fv[r->nFront] = v;
+    r->falc[r->nFront++] = alcance;
+}
+
+int findReachable(Graph g, Isochrone iso, Node src, int crit, CalculaCustoAresta f, double orcamento,
+                  bool reverso) {
+    GraphImpl* G = (GraphImpl*)g;
+    IsochroneImpl* r = (IsochroneImpl*)iso;
+    // Escrevem no grafo: com threads, já feitos por prepareGraphForThreads
+    if (!G->csr.valido || G->csr.f != f) freezeGraph(g, f);
+    CSRImpl* c = &G->csr;
+    if (reverso) garanteReverso(c);
+    const int* off = reverso ? c->roff : c->off;
+    const int* viz = reverso ? c->rorig : c->dest;
+    const double* peso = c->peso[crit];
+    const int* externo = G->externo;
+    if (G->interno) src = G->interno[src];
+    r->nNos = r->nFront = 0;
+    
+    SearchContextImpl* s = (SearchContextImpl*)r->ctx;
+    preparaContexto(s, c, crit, s->tipoFila);
+    double* dist = s->dist;
+    priorityQueue pq = s->pq;
+    tocaNo(s, src);
+    dist[src] = 0;
+    pq_insert(pq, src, 0);
+    
+    // Candidatas à fronteira ficam no próprio vetor: (u alcançado, v)
+    while (!pq_empty(pq)) {
+        if (pq_min_prio(pq) > orcamento) break;
+        int u = pq_extract_min(pq);
+        if (foiVisitado(s, u)) continue;
+        marcaVisitado(s, u);
+        double du = dist[u];
+        isoInsereNo(r, externo ? externo[u] : u, du);
+        
+        for (int i = off[u]; i < off[u+1]; i++) {
+            double w = peso[reverso ? c->rpos[i] : i];
+            if (w == INFINITY) continue;
+            int v = viz[i];
+            double nd = du + w;
+            if (nd > orcamento) {
+                isoInsereFronteira(r, u, v, w > 0 ? (orcamento - du) / w : 1);
+                continue;
+            }
+            tocaNo(s, v);
+            if (nd < dist[v]) {
+                dist[v] = nd;
+                pq_decrease_key(pq, v, nd);
+            }
+        }
+    }
+    
+    // Fica só a fronteira cujo outro extremo não foi alcançado; ids externos
+    // e orientação original da aresta (u -> v no modo direto, v -> u no reverso)
+    int k = 0;
+    for (int j = 0; j < r->nFront; j++) {
+        int u = r->fu[j], v = r->fv[j];
+        if (s->geracao[v] == s->atual && foiVisitado(s, v)) continue;
+        if (externo) { u = externo[u]; v = externo[v]; }
+        r->fu[k] = reverso ? v : u;
+        r->fv[k] = reverso ? u : v;
+        r->falc[k++] = r->falc[j];
+    }
+    r->nFront = k;
+    return r->nNos;
+}
+
+int iso_numNodes(Isochrone iso) { return ((IsochroneImpl*)iso)->nNos; }
+Node iso_getNode(Isochrone iso, int i) { return ((IsochroneImpl*)iso)->nos[i]; }
+double iso_getCost(Isochrone iso, int i) { return ((IsochroneImpl*)iso)->custos[i]; }
+int iso_numFrontier(Isochrone iso) { return ((IsochroneImpl*)iso)->nFront; }
+
+void iso_getFrontier(Isochrone iso, int i, Node* u, Node* v, double* alcance) {
+    IsochroneImpl* r = (IsochroneImpl*)iso;
+    if (u) *u = r->fu[i];
+    if (v) *v = r->fv[i];
+    if (alcance) *alcance = r->falc[i];
+}
+
+void iso_destroy(Isochrone iso) {
+    IsochroneImpl* r = (IsochroneImpl*)iso;
+    destroySearchContext(r->ctx);
+    free(r->nos);
+    free(r->custos);
+    free(r->fu);
+    free(r->fv);
+    free(r->falc);
+    free(r);
+}
+
+// ============================================================================
+// CONSULTAS EM LOTE (THREADS)
+// ============================================================================
+// O grafo é congelado antes de cada lote; a partir daí as threads só leem o
+// snapshot CSR. As threads ficam num pool do grafo, criado no primeiro lote
+// e encerrado em destroyGraph (ou quando setBatchThreads muda o tamanho),
+// dormindo numa variável de condição entre um lote e outro. Cada thread tem
+// sua área de trabalho e pega blocos de LOTE_BLOCO consultas de um contador
+// comum, escrevendo o resultado na mesma posição da entrada.
+// ============================================================================
+#define LOTE_BLOCO 16
+
+typedef struct {
+    const ParRota* pares;
+    ResultadoRota* out;
+    int n, crit;
+    int prox;  // Próxima consulta sem dono (protegido pela trava do pool)
+} Lote;
+
+typedef struct PoolLote PoolLote;
+
+typedef struct {
+    PoolLote* pool;
+    SearchContextImpl* s;
+    pthread_t thread;
+    bool criada;
+} Trabalhador;
+
+struct PoolLote {
+    GraphImpl* G;
+    int nTrab;              // trab[0] é a thread chamadora, as outras são do pool
+    Trabalhador* trab;
+    int nCriadas;           // Threads do pool que pthread_create conseguiu criar
+    pthread_mutex_t trava;
+    pthread_cond_t temLote, loteFeito;
+    Lote* lote;             // Lote em andamento
+    unsigned rodada;        // Incrementada a cada lote despachado
+    int pendentes;          // Threads do pool ainda no lote atual
+    bool encerrar;
+};
+
+static void executaLote(PoolLote* P, SearchContextImpl* s) {
+    Lote* L = P->lote;
+    GraphImpl* G = P->G;
+    while (true) {
+        pthread_mutex_lock(&P->trava);
+        int ini = L->prox;
+        L->prox += LOTE_BLOCO;
+        pthread_mutex_unlock(&P->trava);
+        if (ini >= L->n) break;
+        int fim = ini + LOTE_BLOCO < L->n ? ini + LOTE_BLOCO : L->n;
+        for (int i = ini; i < fim; i++) {
+            Node end = L->pares[i].end;
+            L->out[i].caminho = dijkstraCSR(G, s, L->pares[i].start, end, L->crit);
+            L->out[i].custo = s->dist[G->interno ? G->interno[end] : end];
+        }
+    }
+}
+
+static void* trabalhadorLote(void* arg) {
+    Trabalhador* t = (Trabalhador*)arg;
+    PoolLote* P = t->pool;
+    unsigned vista = 0;  // Última rodada atendida (o pool nasce na rodada 0)
+    pthread_mutex_lock(&P->trava);
+    while (true) {
+        while (!P->encerrar && P->rodada == vista) pthread_cond_wait(&P->temLote, &P->trava);
+        if (P->encerrar) break;
+        vista = P->rodada;
+        pthread_mutex_unlock(&P->trava);
+        executaLote(P, t->s);
+        pthread_mutex_lock(&P->trava);
+        if (--P->pendentes == 0) pthread_cond_signal(&P->loteFeito);
+    }
+    pthread_mutex_unlock(&P->trava);
+    return NULL;
+}
+
+// Cria o pool com nt - 1 threads; a área de trabalho i é G->ctxLote[i]
+static PoolLote* criaPool(GraphImpl* G, int nt) {
+    if (G->nCtxLote < nt) {
+        G->ctxLote = realloc(G->ctxLote, nt * sizeof(SearchContext));
+        for (int i = G->nCtxLote; i < nt; i++) G->ctxLote[i] = createSearchContext();
+        G->nCtxLote = nt;
+    }
+    PoolLote* P = calloc(1, sizeof(PoolLote));
+    P->G = G;
+    P->nTrab = nt;
+    P->trab = calloc(nt, sizeof(Trabalhador));
+    pthread_mutex_init(&P->trava, NULL);
+    pthread_cond_init(&P->temLote, NULL);
+    pthread_cond_init(&P->loteFeito, NULL);
+    for (int i = 0; i < nt; i++) {
+        Trabalhador* t = &P->trab[i];
+        t->pool = P;
+        t->s = (SearchContextImpl*)G->ctxLote[i];
+        // Uma thread que não pôde ser criada não deixa consultas para trás:
+        // as outras continuam pegando blocos até o contador passar de n
+        if (i > 0) t->criada = pthread_create(&t->thread, NULL, trabalhadorLote, t) == 0;
+        if (t->criada) P->nCriadas++;
+    }
+    return P;
+}
+
+static void encerraPool(PoolLote* P) {
+    if (!P) return;
+    pthread_mutex_lock(&P->trava);
+    P->encerrar = true;
+    pthread_cond_broadcast(&P->temLote);
+    pthread_mutex_unlock(&P->trava);
+    for (int i = 1; i < P->nTrab; i++) if (P->trab[i].criada) pthread_join(P->trab[i].thread, NULL);
+    pthread_mutex_destroy(&P->trava);
+    pthread_cond_destroy(&P->temLote);
+    pthread_cond_destroy(&P->loteFeito);
+    free(P->trab);
+    free(P);
+}
+
+void setBatchThreads(Graph g, int nThreads) {
+    ((GraphImpl*)g)->nThreadsLote = nThreads > 0 ? nThreads : 0;
+}
+
+void findPathBatch(Graph g, const ParRota* pares, int n, int crit, CalculaCustoAresta f, ResultadoRota* out) {
+    GraphImpl* G = (GraphImpl*)g;
+    if (n <= 0) return;
+    // Tudo que as buscas gravariam no grafo é feito aqui, antes das threads
+    if (!G->csr.valido || G->csr.f != f) freezeGraph(g, f);
+    int fila = contextoPadrao(G)->tipoFila;
+    double largura; int nBaldes;
+    if (fila == FILA_BALDES) parametrosBaldes(&G->csr, crit, &largura, &nBaldes);
+    
+    int nt = G->nThreadsLote > 0 ? G->nThreadsLote : LOTE_THREADS_PADRAO;
+    if (G->poolLote && G->poolLote->nTrab != nt) {
+        encerraPool(G->poolLote);
+        G->poolLote = NULL;
+    }
+    if (!G->poolLote) G->poolLote = criaPool(G, nt);
+    PoolLote* P = G->poolLote;
+    // As threads do pool estão paradas: dá para mexer nas áreas delas
+    for (int i = 0; i < nt; i++) setSearchQueue(P->trab[i].s, fila);
+    
+    Lote lote = { .pares = pares, .out = out, .n = n, .crit = crit, .prox = 0 };
+    P->lote = &lote;
+    // Um bloco só: não vale acordar o pool
+    bool despacha = P->nCriadas > 0 && n > LOTE_BLOCO;
+    if (despacha) {
+        pthread_mutex_lock(&P->trava);
+        P->pendentes = P->nCriadas;
+        P->rodada++;
+        pthread_cond_broadcast(&P->temLote);
+        pthread_mutex_unlock(&P->trava);
+    }
+    executaLote(P, P->trab[0].s);
+    if (despacha) {
+        pthread_mutex_lock(&P->trava);
+        while (P->pendentes > 0) pthread_cond_wait(&P->loteFeito, &P->trava);
+        pthread_mutex_unlock(&P->trava);
+    }
+    P->lote = NULL;
+}
+
+void setFindPathQueue(Graph g, int fila) {
+    setSearchQueue(contextoPadrao((GraphImpl*)g), fila);
+}
+
+Lista findPathCtx(Graph g, SearchContext ctx, Node start, Node end, int crit, CalculaCustoAresta f) {
+    return findPathModeCtx(g, ctx, start, end, crit, f, BUSCA_DIJKSTRA);
+}
+
+// Monta agora tudo que as buscas construiriam sob demanda no snapshot
+// compartilhado (CSR reverso, escala do A* e baldes de cada critério): depois
+// disso as consultas só leem o grafo
+void prepareGraphForThreads(Graph g, CalculaCustoAresta f) {
+    GraphImpl* G = (GraphImpl*)g;
+    if (!G->csr.valido || G->csr.f != f) freezeGraph(g, f);
+    CSRImpl* c = &G->csr;
+    garanteReverso(c);
+    double largura;
+    int nBaldes;
+    for (int k = 0; k < NUM_CRITERIOS; k++) {
+        escalaHeuristica(c, k);
+        parametrosBaldes(c, k, &largura, &nBaldes);
+    }
+}
+
+Lista findPathModeCtx(Graph g, SearchContext ctx, Node start, Node end, int crit,
+                      CalculaCustoAresta f, int modo) {
+    GraphImpl* G = (GraphImpl*)g;
+    if (!G->csr.valido || G->csr.f != f) freezeGraph(g, f);
+    return buscaModo(G, (SearchContextImpl*)ctx, start, end, crit, modo);
+}
+
+Lista findPathFrozen(Graph g, Node start, Node end, int crit) {
+    GraphImpl* G = (GraphImpl*)g;
+    CSRImpl* c = &G->csr;
+    if (!c->valido) {
+        if (!c->f) return lista_cria();
+        freezeGraph(g, c->f);
+    }
+    return dijkstraCSR(G, contextoPadrao(G), start, end, crit);
+}
+
+// ============================================================================
+// DISTÂNCIAS DE UM PARA TODOS
+// ============================================================================
+// Dijkstra sem destino sobre o snapshot (direto, ou reverso para distâncias
+// até `src`). Base de pré-processamentos como as tabelas de landmarks.
+// ============================================================================
+void shortestDistances(Graph g, Node src, int crit, CalculaCustoAresta f, bool reverso,
+                       double* dist, Node* pai) {
+    GraphImpl* G = (GraphImpl*)g;
+    if (!G->csr.valido || G->csr.f != f) freezeGraph(g, f);
+    CSRImpl* c = &G->csr;
+    if (reverso) garanteReverso(c);
+    int n = c->n;
+    const int* off = reverso ? c->roff : c->off;
+    const int* viz = reverso ? c->rorig : c->dest;
+    const double* peso = c->peso[crit];
+    if (G->interno) src = G->interno[src];
+    
+    double* d = malloc(n * sizeof(double));
+    int* p = malloc(n * sizeof(int));
+    for (int i = 0; i < n; i++) { d[i] = DBL_MAX; p[i] = -1; }
+    priorityQueue pq = createIndexedPriorityQueue(n, PQ_ARIDADE_PADRAO);
+    d[src] = 0;
+    pq_insert(pq, src, 0);
+    while (!pq_empty(pq)) {
+        int u = pq_extract_min(pq);
+        double du = d[u];
+        for (int i = off[u]; i < off[u+1]; i++) {
+            int v = viz[i];
+            double nd = du + peso[reverso ? c->rpos[i] : i];
+            if (nd < d[v]) {
+                d[v] = nd;
+                p[v] = u;
+                pq_decrease_key(pq, v, nd);
+            }
+        }
+    }
+    pq_destroy(pq);
+    
+    // De volta para os ids externos
+    for (int r = 0; r < n; r++) {
+        int v = G->externo ? G->externo[r] : r;
+        dist[v] = d[r];
+        if (pai) pai[v] = (p[r] == -1 || !G->externo) ? p[r] : G->externo[p[r]];
+    }
+    free(d);
+    free(p);
+}
+
+// ============================================================================
+// DELTA-STEPPING (UM PARA TODOS EM PARALELO)
+// ============================================================================
+// Os nós são agrupados em baldes de largura delta pela distância. O balde
+// corrente é processado em rodadas: todas as arestas leves (peso <= delta)
+// da fronteira são relaxadas em paralelo, e os nós melhorados que caem no
+// mesmo balde formam a próxima fronteira. Quando o balde esvazia, as
+// arestas pesadas dos nós que passaram por ele são relaxadas uma única vez.
+//
+// dist[] guarda os bits dos double como uint64: para valores >= 0 a ordem é
+// a mesma, então "diminuir se menor" é um CAS de inteiro. A fila de baldes
+// (sequencial, na thread chamadora) é um heap com entradas repetidas,
+// ordenado pela distância; o balde corrente é tudo abaixo de (i+1)*delta.
+//
+// As distâncias são as mesmas de shortestDistances: os dois convergem para
+// o mesmo d[v] = min(d[u] + w(u,v)). O pai é escolhido no fim entre as
+// arestas que realizam d[v] e pode diferir do Dijkstra em empates.
+// ============================================================================
+#define FASE_LEVES 0
+#define FASE_PESADAS 1
+#define FASE_PAIS 2
+#define FASE_FIM 3
+
+typedef struct { int* v; int n, cap; } VetInt;
+
+static void vetInsere(VetInt* a, int x) {
+    if (a->n == a->cap) {
+        a->cap = a->cap ? 2*a->cap : 64;
+        a->v = realloc(a->v, a->cap * sizeof(int));
+    }
+    a->v[a->n++] = x;
+}
+
+static inline uint64_t bitsDe(double x) { uint64_t b; memcpy(&b, &x, sizeof b); return b; }
+static inline double doubleDe(uint64_t b) { double x; memcpy(&x, &b, sizeof x); return x; }
+
+#if defined(__GNUC__)
+#define LE_ATOMICO(p) __atomic_load_n((p), __ATOMIC_RELAXED)
+// dist[v] = min(dist[v], valor); true se diminuiu
+static inline bool minAtomico(uint64_t* alvo, double valor) {
+    uint64_t novo = bitsDe(valor);
+    uint64_t velho = __atomic_load_n(alvo, __ATOMIC_RELAXED);
+    while (novo < velho)
+        if (__atomic_compare_exchange_n(alvo, &velho, novo, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+            return true;
+    return false;
+}
+#else
+// Sem atômicos do GCC: deltaStepping roda com uma thread só
+#define LE_ATOMICO(p) (*(p))
+static inline bool minAtomico(uint64_t* alvo, double valor) {
+    uint64_t novo = bitsDe(valor);
+    if (novo >= *alvo) return false;
+    *alvo = novo;
+    return true;
+}
+#endif
+
+// Barreira simples (mutex + cond): pthread_barrier_t não existe em todas as
+// plataformas nem no modo -std=c99 sem macros POSIX
+typedef struct {
+    pthread_mutex_t trava;
+    pthread_cond_t cond;
+    int total, chegaram, geracao;
+} Barreira;
+
+static void barreiraInit(Barreira* b, int total) {
+    pthread_mutex_init(&b->trava, NULL);
+    pthread_cond_init(&b->cond, NULL);
+    b->total = total;
+    b->chegaram = 0;
+    b->geracao = 0;
+}
+
+static void barreiraEspera(Barreira* b) {
+    pthread_mutex_lock(&b->trava);
+    int ger = b->geracao;
+    if (++b->chegaram == b->total) {
+        b->chegaram = 0;
+        b->geracao++;
+        pthread_cond_broadcast(&b->cond);
+    } else {
+        while (ger == b->geracao) pthread_cond_wait(&b->cond, &b->trava);
+    }
+    pthread_mutex_unlock(&b->trava);
+}
+
+static void barreiraDestroi(Barreira* b) {
+    pthread_mutex_destroy(&b->trava);
+    pthread_cond_destroy(&b->cond);
+}
+
+typedef struct {
+    CSRImpl* c;
+    const double* peso;
+    double delta;
+    int nt;
+    int origem;
+    uint64_t* dist;
+    int* pai;               // Interno, preenchido na FASE_PAIS
+    const int* fronteira;   // Nós da rodada (lida por todas as threads)
+    int nFronteira;
+    int fase;
+    VetInt* melhorados;     // Um vetor por thread: nós cuja dist diminuiu
+    Barreira barreira;
+} DeltaStep;
+
+typedef struct { DeltaStep* D; int t; } FatiaDelta;
+
+static void executaFatia(DeltaStep* D, int t) {
+    CSRImpl* c = D->c;
+    if (D->fase == FASE_PAIS) {
+        // Pai de v: uma aresta u -> v de peso > 0 com d[u] + w == d[v]. Quem
+        // só é alcançado por arestas de peso 0 fica com -2 e é resolvido
+        // depois, em sequência, para não fechar ciclos de pais.
+        int ini = (int)((long long)c->n * t / D->nt), fim = (int)((long long)c->n * (t+1) / D->nt);
+        for (int v = ini; v < fim; v++) {
+            D->pai[v] = -1;
+            double dv = doubleDe(D->dist[v]);
+            if (v == D->origem || dv == DBL_MAX) continue;
+            D->pai[v] = -2;
+            for (int k = c->roff[v]; k < c->roff[v+1]; k++) {
+                int u = c->rorig[k];
+                double w = D->peso[c->rpos[k]];
+                if (w > 0 && doubleDe(D->dist[u]) + w == dv) { D->pai[v] = u; break; }
+            }
+        }
+        return;
+    }
+    bool leves = D->fase == FASE_LEVES;
+    int ini = (int)((long long)D->nFronteira * t / D->nt);
+    int fim = (int)((long long)D->nFronteira * (t+1) / D->nt);
+    for (int k = ini; k < fim; k++) {
+        int u = D->fronteira[k];
+        double du = doubleDe(LE_ATOMICO(&D->dist[u]));
+        for (int i = c->off[u]; i < c->off[u+1]; i++) {
+            double w = D->peso[i];
+            if (w == INFINITY || (w <= D->delta) != leves) continue;
+            int v = c->dest[i];
+            if (minAtomico(&D->dist[v], du + w)) vetInsere(&D->melhorados[t], v);
+        }
+    }
+}
+
+static void* trabalhadorDelta(void* arg) {
+    FatiaDelta* f = (FatiaDelta*)arg;
+    DeltaStep* D = f->D;
+    while (true) {
+        barreiraEspera(&D->barreira);  // Espera a rodada ser publicada
+        if (D->fase == FASE_FIM) break;
+        executaFatia(D, f->t);
+        barreiraEspera(&D->barreira);  // Rodada concluída
+    }
+    return NULL;
+}
+
+// Executa uma rodada em todas as threads (a chamadora faz a fatia 0)
+static void rodadaDelta(DeltaStep* D, int fase, const int* nos, int n) {
+    D->fase = fase;
+    D->fronteira = nos;
+    D->nFronteira = n;
+    if (D->nt > 1) barreiraEspera(&D->barreira);
+    executaFatia(D, 0);
+    if (D->nt > 1) barreiraEspera(&D->barreira);
+}
+
+void deltaStepping(Graph g, Node src, int crit, CalculaCustoAresta f, double delta, int nThreads,
+                   double* dist, Node* pai) {
+    GraphImpl* G = (GraphImpl*)g;
+    if (!G->csr.valido || G->csr.f != f) freezeGraph(g, f);
+    CSRImpl* c = &G->csr;
+    garanteReverso(c);  // Para a escolha dos pais; feito antes das threads
+    int n = c->n;
+    if (G->interno) src = G->interno[src];
+    
+    DeltaStep D = {0};
+    D.c = c;
+    D.peso = c->peso[crit];
+    if (delta <= 0) {
+        // Padrão: peso médio das arestas
+        double soma = 0; int cnt = 0;
+        for (int i = 0; i < c->off[n]; i++) if (D.peso[i] != INFINITY) { soma += D.peso[i]; cnt++; }
+        delta = (cnt > 0 && soma > 0) ? soma / cnt : 1;
+    }
+    D.delta = delta;
+#if defined(__GNUC__)
+    D.nt = nThreads > 0 ? nThreads : LOTE_THREADS_PADRAO;
+#else
+    D.nt = 1;
+#endif
+    D.dist = malloc(n * sizeof(uint64_t));
+    D.pai = malloc(n * sizeof(int));
+    D.melhorados = calloc(D.nt, sizeof(VetInt));
+    uint64_t infinito = bitsDe(DBL_MAX);
+    for (int i = 0; i < n; i++) D.dist[i] = infinito;
+    
+    pthread_t* threads = malloc(D.nt * sizeof(pthread_t));
+    FatiaDelta* fatias = malloc(D.nt * sizeof(FatiaDelta));
+    bool comBarreira = D.nt > 1;
+    if (comBarreira) barreiraInit(&D.barreira, D.nt);
+    int criadas = 1;
+    for (int t = 1; t < D.nt; t++) {
+        fatias[t] = (FatiaDelta){ &D, t };
+        if (pthread_create(&threads[t], NULL, trabalhadorDelta, &fatias[t]) != 0) break;
+        criadas++;
+    }
+    if (criadas < D.nt) {
+        // Falhou ao criar alguma: segue com as que existem (nenhuma passou
+        // da primeira barreira ainda, então basta reduzir o total)
+        pthread_mutex_lock(&D.barreira.trava);
+        D.barreira.total = criadas;
+        pthread_mutex_unlock(&D.barreira.trava);
+        D.nt = criadas;
+    }
+    
+    // Fila de baldes e marcas de rodada (evitam nó repetido na fronteira)
+    priorityQueue pq = createPriorityQueue(n);
+    int* marca = calloc(n, sizeof(int));     // Rodada em que entrou na fronteira
+    int* marcaR = calloc(n, sizeof(int));    // Balde em que entrou em R
+    VetInt fronteira = {0}, R = {0};
+    int rodada = 0, balde = 0;
+    D.origem = src;
+    D.dist[src] = bitsDe(0);
+    pq_insert(pq, src, 0);
+    
+    while (!pq_empty(pq)) {
+        balde++;
+        double limite = (floor(pq_min_prio(pq) / delta) + 1) * delta;
+        R.n = 0;
+        while (!pq_empty(pq) && pq_min_prio(pq) < limite) {
+            // Fronteira = entradas atuais do balde (as velhas são puladas)
+            rodada++;
+            fronteira.n = 0;
+            while (!pq_empty(pq) && pq_min_prio(pq) < limite) {
+                double p = pq_min_prio(pq);
+                int u = pq_extract_min(pq);
+                if (p > doubleDe(D.dist[u]) || marca[u] == rodada) continue;
+                marca[u] = rodada;
+                vetInsere(&fronteira, u);
+                if (marcaR[u] != balde) { marcaR[u] = balde; vetInsere(&R, u); }
+            }
+            rodadaDelta(&D, FASE_LEVES, fronteira.v, fronteira.n);
+            for (int t = 0; t < D.nt; t++) {
+                for (int k = 0; k < D.melhorados[t].n; k++) {
+                    int v = D.melhorados[t].v[k];
+                    pq_insert(pq, v, doubleDe(D.dist[v]));
+                }
+                D.melhorados[t].n = 0;
+            }
+        }
+        // Nós de R estão definitivos: arestas pesadas uma vez só
+        rodadaDelta(&D, FASE_PESADAS, R.v, R.n);
+        for (int t = 0; t < D.nt; t++) {
+            for (int k = 0; k < D.melhorados[t].n; k++) {
+                int v = D.melhorados[t].v[k];
+                pq_insert(pq, v, doubleDe(D.dist[v]));
+            }
+            D.melhorados[t].n = 0;
+        }
+    }
+    rodadaDelta(&D, FASE_PAIS, NULL, 0);
+    
+    if (D.nt > 1) {
+        D.fase = FASE_FIM;
+        barreiraEspera(&D.barreira);
+        for (int t = 1; t < D.nt; t++) pthread_join(threads[t], NULL);
+    }
+    if (comBarreira) barreiraDestroi(&D.barreira);
+    
+    // Pais pendentes (só arestas de peso 0): busca em largura a partir dos
+    // nós já resolvidos, seguindo arestas de peso 0 entre distâncias iguais
+    fronteira.n = 0;
+    for (int v = 0; v < n; v++) if (D.pai[v] == -2) { fronteira.n = 1; break; }
+    if (fronteira.n) {
+        fronteira.n = 0;
+        for (int v = 0; v < n; v++) if (D.pai[v] >= 0 || v == src) vetInsere(&fronteira, v);
+        for (int k = 0; k < fronteira.n; k++) {
+            int u = fronteira.v[k];
+            for (int i = c->off[u]; i < c->off[u+1]; i++) {
+                int v = c->dest[i];
+                if (D.pai[v] == -2 && D.peso[i] == 0 && D.dist[v] == D.dist[u]) {
+                    D.pai[v] = u;
+                    vetInsere(&fronteira, v);
+                }
+            }
+        }
+    }
+    
+    // De volta para os ids externos
+    for (int r = 0; r < n; r++) {
+        int v = G->externo ? G->externo[r] : r;
+        dist[v] = doubleDe(D.dist[r]);
+        if (pai) pai[v] = (D.pai[r] == -1 || !G->externo) ? D.pai[r] : G->externo[D.pai[r]];
+    }
+    pq_destroy(pq);
+    free(marca);
+    free(marcaR);
+    free(fronteira.v);
+    free(R.v);
+    for (int t = 0; t < D.nt; t++) free(D.melhorados[t].v);
+    free(D.melhorados);
+    free(D.dist);
+    free(D.pai);
+    free(threads);
+    free(fatias);
+}
+
+// ============================================================================
+// ÁRVORE DE CAMINHOS MÍNIMOS REUTILIZÁVEL
+// ============================================================================
+// Um Dijkstra completo a partir de `src` guarda dist[] e pai[] de todos os
+// nós. Cada destino custa só a subida pela árvore, enquanto a versão do grafo
+// for a mesma da construção.
+// ============================================================================
+typedef struct {
+    Graph g;
+    Node src;
+    int n;
+    unsigned long versao;
+    double* dist;
+    Node* pai;
+} SPTImpl;
+
+ShortestPathTree createSPT(Graph g, Node src, int crit, CalculaCustoAresta f) {
+    SPTImpl* t = malloc(sizeof(SPTImpl));
+    int n = getTotalNodes(g);
+    t->g = g;
+    t->src = src;
+    t->n = n;
+    t->dist = malloc((n > 0 ? n : 1) * sizeof(double));
+    t->pai = malloc((n > 0 ? n : 1) * sizeof(Node));
+    shortestDistances(g, src, crit, f, false, t->dist, t->pai);
+    t->versao = getGraphVersion(g);  // Depois: shortestDistances pode congelar o grafo
+    return t;
+}
+
+Lista spt_path(ShortestPathTree spt, Node dest) {
+    SPTImpl* t = (SPTImpl*)spt;
+    Lista path = lista_cria();
+    if (dest < 0 || dest >= t->n || t->dist[dest] == DBL_MAX) return path;
+    // Mede o caminho antes, para alocar só O(caminho)
+    int count = 0;
+    for (Node v = dest; v != -1; v = t->pai[v]) count++;
+    Node* temp = malloc(count * sizeof(Node));
+    int i = count;
+    for (Node v = dest; v != -1; v = t->pai[v]) temp[--i] = v;
+    for (i = 0; i < count; i++) lista_insere(path, (void*)(intptr_t)temp[i]);
+    free(temp);
     return path;
-}
\ No newline at end of file
+}
+
+double spt_cost(ShortestPathTree spt, Node dest) {
+    SPTImpl* t = (SPTImpl*)spt;
+    if (dest < 0 || dest >= t->n) return DBL_MAX;
+    return t->dist[dest];
+}
+
+Node spt_getSource(ShortestPathTree spt) { return ((SPTImpl*)spt)->src; }
+
+bool spt_isStale(ShortestPathTree spt) {
+    SPTImpl* t = (SPTImpl*)spt;
+    return t->versao != getGraphVersion(t->g);
+}
+
+void spt_destroy(ShortestPathTree spt) {
+    SPTImpl* t = (SPTImpl*)spt;
+    free(t->dist);
+    free(t->pai);
+    free(t);
+}
+
+// ============================================================================
+// REORDENAÇÃO DE NÓS (localidade de memória)
+// ============================================================================
+// Os ids externos (devolvidos por addNode) nunca mudam. O que muda é a ordem
+// das linhas do snapshot CSR: nós próximos na malha viária passam a ficar
+// próximos na memória, o que reduz cache misses do Dijkstra.
+typedef struct { uint64_t chave; int id; } ChaveNo;
+
+static int comparaChave(const void* a, const void* b) {
+    const ChaveNo* x = (const ChaveNo*)a;
+    const ChaveNo* y = (const ChaveNo*)b;
+    if (x->chave != y->chave) return x->chave < y->chave ? -1 : 1;
+    return x->id - y->id;
+}
+
+// Distância ao longo da curva de Hilbert de lado `n` (potência de 2)
+static uint64_t hilbertD(uint32_t n, uint32_t x, uint32_t y) {
+    uint64_t d = 0;
+    for (uint32_t s = n/2; s > 0; s /= 2) {
+        uint32_t rx = (x & s) > 0;
+        uint32_t ry = (y & s) > 0;
+        d += (uint64_t)s * s * ((3 * rx) ^ ry);
+        // Rotaciona o quadrante para manter a curva contínua
+        if (ry == 0) {
+            if (rx == 1) { x = n-1 - x; y = n-1 - y; }
+            uint32_t t = x; x = y; y = t;
+        }
+    }
+    return d;
+}
+
+static void ordemHilbert(GraphImpl* G, int* externo) {
+    int n = G->count;
+    double minX = DBL_MAX, minY = DBL_MAX, maxX = -DBL_MAX, maxY = -DBL_MAX;
+    for (int i = 0; i < n; i++) {
+        if (G->x[i] < minX) minX = G->x[i];
+        if (G->x[i] > maxX) maxX = G->x[i];
+        if (G->y[i] < minY) minY = G->y[i];
+        if (G->y[i] > maxY) maxY = G->y[i];
+    }
+    // Quantiza as coordenadas numa grade 2^16 x 2^16
+    const uint32_t lado = 1u << 16;
+    double ext = fmax(maxX - minX, maxY - minY);
+    double escala = ext > 0 ? (lado - 1) / ext : 0;
+    
+    ChaveNo* v = malloc(n * sizeof(ChaveNo));
+    for (int i = 0; i < n; i++) {
+        uint32_t qx = (uint32_t)((G->x[i] - minX) * escala);
+        uint32_t qy = (uint32_t)((G->y[i] - minY) * escala);
+        v[i].chave = hilbertD(lado, qx, qy);
+        v[i].id = i;
+    }
+    qsort(v, n, sizeof(ChaveNo), comparaChave);
+    for (int i = 0; i < n; i++) externo[i] = v[i].id;
+    free(v);
+}
+
+// Ordem de visita de uma BFS (componentes visitados em ordem de id)
+static void ordemBFS(GraphImpl* G, int* externo) {
+    int n = G->count, k = 0;
+    bool* visto = calloc(n, sizeof(bool));
+    Fila f = fila_cria();
+    for (int r = 0; r < n; r++) {
+        if (visto[r]) continue;
+        visto[r] = true;
+        fila_insere(f, (void*)(intptr_t)r);
+        while (!fila_vazia(f)) {
+            int u = (int)(intptr_t)fila_remove(f);
+            externo[k++] = u;
+            for (EdgeImpl* e = G->nodes[u].prim; e; e = e->prox) {
+                if (!e->removida && !visto[e->dest]) {
+                    visto[e->dest] = true;
+                    fila_insere(f, (void*)(intptr_t)e->dest);
+                }
+            }
+        }
+    }
+    fila_libera(f);
+    free(visto);
+}
+
+void reorderGraph(Graph g, int metodo) {
+    GraphImpl* G = (GraphImpl*)g;
+    int n = G->count;
+    int* externo = malloc(G->max * sizeof(int));
+    int* interno = malloc(G->max * sizeof(int));
+    
+    if (metodo == REORDENA_BFS) ordemBFS(G, externo);
+    else ordemHilbert(G, externo);
+    for (int i = 0; i < n; i++) interno[externo[i]] = i;
+    
+    free(G->externo);
+    free(G->interno);
+    G->externo = externo;
+    G->interno = interno;
+    G->nOrdem = n;
+    G->csr.valido = false;  // Próxima consulta reconstrói na nova ordem
+}
@@ -1,6 +1,7 @@
 #ifndef GRAPH_H
 #define GRAPH_H
 #include "lista.h"
+#include "arena.h"
 #include <stdbool.h>
 
 typedef void* Graph;
@@ -10,35 +11,258 @@ typedef void* Edge;
 
 #define CRITERIO_DISTANCIA 0
 #define CRITERIO_TEMPO 1
+#define NUM_CRITERIOS 2
 
 typedef double (*CalculaCustoAresta)(Info info, int criterio);
 
 Graph createGraph(int n, bool dir, char* nome);
-// Cria um grafo com capacidade para `n` nós.
+// Cria um grafo com capacidade inicial para `n` nós (n <= 0 usa um padrão).
+// A capacidade é apenas uma dica: o grafo cresce sob demanda.
 // `dir` indica se o grafo é dirigido (true) ou não.
+void destroyGraph(Graph g);
+// Libera o grafo e, numa única operação, tudo que foi alocado na sua arena.
+Arena getGraphArena(Graph g);
+// Arena do grafo: infos de nós/arestas alocadas aqui vivem até destroyGraph.
 Node addNode(Graph g, char* nome, Info info);
-// Adiciona um nó ao grafo e retorna seu índice.
+// Adiciona um nó ao grafo e retorna seu índice (estável mesmo após crescer).
 Edge addEdge(Graph g, Node u, Node v, Info info);
 // Adiciona uma aresta do nó `u` para `v` associando `info`.
 Node getNode(Graph g, char* nome);
 // Retorna o índice do nó com nome dado, ou -1 se não existir.
+// Usa um índice hash interno: O(1) esperado.
 Info getNodeInfo(Graph g, Node n);
 // Retorna o ponteiro `Info` armazenado no nó `n`.
 int getTotalNodes(Graph g);
+unsigned long getGraphVersion(Graph g);
+// Versão monotônica do grafo: muda a cada addNode, addEdge, setEdgeAttr,
+// removeEdge ou restoreEdge. Estruturas derivadas (caches, pré-processamentos)
+// guardam a versão com que foram construídas para detectar que ficaram velhas.
 
 // --- CORREÇÃO AQUI ---
 // Preenche `l` com as estruturas de aresta adjacentes ao nó `n`.
 void adjacentEdges(Graph g, Node n, Lista l);
 // Preenche `l` com os nós adjacentes (IDs) de `n`.
 void adjacentNodes(Graph g, Node n, Lista l);
+// Preenche `l` com as arestas que chegam em `n` (adjacência reversa).
+void incomingEdges(Graph g, Node n, Lista l);
+// Preenche `l` com os nós (IDs) que têm aresta para `n`.
+void incomingNodes(Graph g, Node n, Lista l);
 // ---------------------
 
+Edge findEdge(Graph g, Node u, Node v);
+// Aresta u -> v em O(1) esperado (índice hash interno), ou NULL se não
+// existir. Com arestas paralelas, devolve a inserida por último; arestas
+// removidas com removeEdge são ignoradas.
 Node getToNode(Graph g, Edge e);
+Node getFromNode(Graph g, Edge e);
 Info getEdgeInfo(Graph g, Edge e);
+void setEdgeAttr(Graph g, Edge e, Info info);
+// Atualiza o `Info` da aresta (pode ser o mesmo ponteiro, após alterá-lo
+// in-place) e recalcula seus pesos em cache. Alterações feitas direto no
+// `Info` sem passar por aqui não são vistas por findPath.
+void removeEdge(Graph g, Edge e);
+// Desativa a aresta: some de adjacentEdges/adjacentNodes e das buscas.
+void restoreEdge(Graph g, Edge e);
+// Reativa uma aresta removida com removeEdge.
+bool isEdgeRemoved(Graph g, Edge e);
+
+// Coordenadas pertencem ao grafo (arrays x[]/y[] contíguos), não ao `Info`.
+void setNodeCoord(Graph g, Node n, double x, double y);
+void getNodeCoord(Graph g, Node n, double* x, double* y);
 
 Node findNearestNode(Graph g, double x, double y);
+// Nó mais próximo de (x, y): varredura linear vetorizada (SSE2/AVX)
+// sobre as coordenadas, usada quando não há índice espacial.
 // Encontra um caminho mínimo entre `start` e `end` segundo `crit`.
-// Implementa Dijkstra usando a função de custo `f`.
+// Implementa Dijkstra usando a função de custo `f`. Os pesos de cada
+// critério ficam em cache no grafo e `f` só é chamada ao (re)construí-lo.
 Lista findPath(Graph g, Node start, Node end, int crit, CalculaCustoAresta f);
 
+#define BUSCA_DIJKSTRA 0      // Busca unidirecional a partir de start
+#define BUSCA_BIDIRECIONAL 1  // Buscas alternadas de start e de end (critério mu)
+#define BUSCA_ASTAR 2         // A* guiado pela distância euclidiana até end
+Lista findPathMode(Graph g, Node start, Node end, int crit, CalculaCustoAresta f, int modo);
+// Igual a findPath, escolhendo o algoritmo de busca em `modo`.
+
+typedef void* SearchContext;
+SearchContext createSearchContext(void);
+// Área de trabalho de busca (dist, pai, fila, visitados) reaproveitada entre
+// consultas: só os nós tocados por cada consulta são reiniciados.
+// findPath usa uma área do próprio grafo; threads devem ter a sua.
+void destroySearchContext(SearchContext ctx);
+Lista findPathCtx(Graph g, SearchContext ctx, Node start, Node end, int crit, CalculaCustoAresta f);
+// Igual a findPath, usando a área de trabalho `ctx`. Com várias threads,
+// chame prepareGraphForThreads antes das consultas.
+Lista findPathModeCtx(Graph g, SearchContext ctx, Node start, Node end, int crit,
+                      CalculaCustoAresta f, int modo);
+// Igual a findPathMode, usando a área de trabalho `ctx` (a bidirecional usa
+// também uma segunda área, criada dentro de `ctx` no primeiro uso).
+void prepareGraphForThreads(Graph g, CalculaCustoAresta f);
+// Congela o grafo com `f` (se preciso) e monta os caches que as buscas
+// criariam no primeiro uso: CSR reverso, escala do A* e parâmetros dos
+// baldes de todos os critérios. Só então consultas com áreas de trabalho
+// próprias podem rodar em paralelo, e só enquanto o grafo não muda: depois
+// de qualquer alteração (inclusive setEdgeAttr, removeEdge, restoreEdge e
+// setNodeCoord), chame de novo antes de voltar às threads.
+
+#define FILA_HEAP 0    // Heap 4-ário indexado com decrease-key (padrão)
+#define FILA_RADIX 1   // Radix heap monótono sobre os bits dos custos
+#define FILA_BALDES 2  // Baldes de Dial com largura = menor peso do critério
+void setSearchQueue(SearchContext ctx, int fila);
+// Fila de prioridade usada pelas buscas com `ctx`. FILA_BALDES cai para
+// FILA_RADIX quando não se aplica (arestas de peso 0, pesos muito
+// desiguais, ou A*).
+void setFindPathQueue(Graph g, int fila);
+// Idem para a área de trabalho do grafo (findPath, findPathMode, A*).
+
+typedef struct { Node start; Node end; } ParRota;
+typedef struct {
+    Lista caminho;  // Mesmo formato de findPath (vazia se não há caminho)
+    double custo;   // DBL_MAX se não há caminho
+} ResultadoRota;
+#define LOTE_THREADS_PADRAO 4
+void findPathBatch(Graph g, const ParRota* pares, int n, int crit, CalculaCustoAresta f, ResultadoRota* out);
+// Resolve as `n` consultas em paralelo, com uma área de trabalho por thread
+// sobre o grafo congelado. out[i] corresponde a pares[i]; o chamador libera
+// cada out[i].caminho. O grafo não pode ser alterado durante a chamada.
+// As threads são criadas no primeiro lote e reaproveitadas pelos seguintes
+// até destroyGraph; chamadas a findPathBatch no mesmo grafo não podem ser
+// simultâneas.
+void setBatchThreads(Graph g, int nThreads);
+// Threads usadas por findPathBatch (<= 0 volta a LOTE_THREADS_PADRAO).
+
+void setQuantizedWeights(Graph g, int crit, double escala);
+// Liga (escala > 0) ou desliga (escala <= 0) uma cópia uint32 dos pesos de
+// `crit`, arredondados para peso * escala (ex.: 100 para centímetros se o
+// peso está em metros, 10 para décimos de segundo). Pesos que não cabem em
+// uint32 deixam a aresta fora da busca inteira. A cópia acompanha
+// setEdgeAttr/removeEdge/restoreEdge e novos freezeGraph.
+// Memória: a coluna uint32 é somada à double (que as outras buscas usam),
+// então o snapshot cresce 4 bytes por aresta por critério ligado, em vez
+// de diminuir. O que cai pela metade são os pesos lidos e os rótulos da
+// busca inteira (4 bytes por nó em vez de 8); uma área de trabalho usada
+// só por findPathQuantized não aloca os rótulos double.
+Lista findPathQuantized(Graph g, Node start, Node end, int crit, CalculaCustoAresta f, unsigned* custo);
+// Dijkstra com pesos e rótulos inteiros. Se `custo` != NULL recebe o custo
+// do caminho na escala (UINT32_MAX se não há caminho). Sem pesos inteiros
+// ligados para `crit`, faz a busca double de findPath (custo = UINT32_MAX).
+
+#define PERIODO_PERFIL 86400.0  // Perfis de tempo repetem a cada 24h (segundos)
+int createTimeProfile(Graph g, const double* horarios, const double* fatores, int n);
+// Perfil de tempo linear por partes no pool do grafo: em `horarios[i]`
+// (segundos desde 0h, crescentes em [0, PERIODO_PERFIL)) o tempo da aresta
+// é `fatores[i]` (> 0) vezes o tempo base; depois do último ponto volta ao
+// primeiro. Perfis idênticos são guardados uma vez. Retorna o id ou -1.
+int getNumTimeProfiles(Graph g);
+bool setEdgeProfile(Graph g, Edge e, int perfil, CalculaCustoAresta f);
+// Associa o perfil à aresta (-1 remove). Recusa (false) se a aresta, com
+// tempo base f(info, CRITERIO_TEMPO), violaria FIFO: sair mais tarde não
+// pode fazer chegar mais cedo.
+Lista findPathTD(Graph g, Node start, Node end, CalculaCustoAresta f, double partida, double* chegada);
+// Rota mais rápida saindo de `start` no horário `partida` (segundos, mesma
+// unidade de CRITERIO_TEMPO), com o tempo de cada aresta avaliado no
+// horário em que ela é percorrida. `chegada` recebe o horário de chegada
+// (DBL_MAX se não há caminho). Arestas sem perfil usam o tempo base.
+
+#define CONVERSAO_PROIBIDA (-1.0)
+bool setTurnCost(Graph g, Edge de, Edge para, double custo);
+// Custo da conversão da aresta `de` (u -> v) para `para` (v -> w), ou
+// CONVERSAO_PROIBIDA. Redefinir um par substitui o custo anterior. Custos
+// são tempo (somados só em CRITERIO_TEMPO); proibições valem em todos os
+// critérios. false se `para` não sai do destino de `de`.
+void setUTurnCost(Graph g, double custo);
+// Custo do retorno (u -> v seguido de v -> u) sem entrada na tabela.
+// Padrão 0; CONVERSAO_PROIBIDA proíbe todos os retornos.
+int getNumTurns(Graph g);
+// Pares (de, para) distintos na tabela de conversões.
+Lista findPathTurns(Graph g, Node start, Node end, int crit, CalculaCustoAresta f, double* custo);
+// Caminho mínimo respeitando a tabela de conversões (busca com uma aresta
+// por estado). `custo` (se != NULL) recebe o custo com as conversões, ou
+// DBL_MAX se não há caminho. Pode passar pelo mesmo nó mais de uma vez.
+
+typedef struct {
+    Lista caminho;     // Nós, como em findPath
+    double distancia;  // Custo em CRITERIO_DISTANCIA
+    double tempo;      // Custo em CRITERIO_TEMPO
+} RotaPareto;
+#define PARETO_ROTULOS_PADRAO 32
+Lista findPathPareto(Graph g, Node start, Node end, CalculaCustoAresta f, int maxRotulos);
+// Fronteira de Pareto distância x tempo de start até end: lista de
+// RotaPareto* em ordem de distância crescente (e tempo decrescente), sem
+// rotas dominadas. Cada nó guarda no máximo `maxRotulos` rótulos (<= 0 usa
+// PARETO_ROTULOS_PADRAO); com o limite atingido a fronteira pode ficar
+// incompleta, mas nunca traz rota dominada. Liberar com destroyParetoRoutes.
+void destroyParetoRoutes(Lista rotas);
+
+typedef void* Isochrone;
+Isochrone createIsochrone(void);
+// Resultado e área de trabalho de findReachable, reaproveitados entre
+// consultas. Para consultar o mesmo grafo de várias threads, cada uma com
+// o seu Isochrone, chame antes prepareGraphForThreads: sem ela, a primeira
+// consulta (e a primeira reversa) montam o snapshot e o CSR reverso
+// compartilhados e precisam rodar sozinhas.
+int findReachable(Graph g, Isochrone iso, Node src, int crit, CalculaCustoAresta f, double orcamento,
+                  bool reverso);
+// Nós a custo <= `orcamento` de `src` (ou, se `reverso`, que chegam em `src`
+// com esse custo), guardados em `iso` em ordem de custo. Retorna quantos.
+// Após a primeira consulta não aloca nem varre O(V).
+int iso_numNodes(Isochrone iso);
+Node iso_getNode(Isochrone iso, int i);
+double iso_getCost(Isochrone iso, int i);
+int iso_numFrontier(Isochrone iso);
+void iso_getFrontier(Isochrone iso, int i, Node* u, Node* v, double* alcance);
+// Aresta u -> v cortada pelo orçamento: uma ponta alcançada e a outra não.
+// `alcance` é a fração da aresta coberta a partir da ponta alcançada.
+void iso_destroy(Isochrone iso);
+
+typedef double (*Heuristica)(Node v, Node end, void* ctx);
+// Limite inferior do custo de v até end (ids externos). Precisa ser
+// consistente: h(u) <= w(u,v) + h(v) para toda aresta, e h(end) = 0.
+Lista findPathAStar(Graph g, Node start, Node end, int crit, CalculaCustoAresta f,
+                    Heuristica h, void* ctx);
+// A* com heurística fornecida pelo chamador (ex.: landmarks, ver alt.h).
+
+void shortestDistances(Graph g, Node src, int crit, CalculaCustoAresta f, bool reverso,
+                       double* dist, Node* pai);
+// Distâncias de `src` para todos os nós (ou de todos até `src`, se
+// `reverso`). `dist` deve ter getTotalNodes(g) posições; DBL_MAX indica nó
+// inalcançável. Se `pai` != NULL, recebe o predecessor de cada nó na árvore
+// de caminhos mínimos (-1 na raiz e nos inalcançáveis); no modo reverso é o
+// próximo nó rumo a `src`.
+
+void deltaStepping(Graph g, Node src, int crit, CalculaCustoAresta f, double delta, int nThreads,
+                   double* dist, Node* pai);
+// Mesmo resultado de shortestDistances (modo direto) com delta-stepping em
+// `nThreads` threads (<= 0 usa LOTE_THREADS_PADRAO). `delta` é a largura dos
+// baldes (<= 0 usa o peso médio das arestas). As distâncias são idênticas;
+// em empates o pai pode ser outro caminho mínimo.
+
+typedef void* ShortestPathTree;
+ShortestPathTree createSPT(Graph g, Node src, int crit, CalculaCustoAresta f);
+// Calcula e guarda a árvore de caminhos mínimos completa a partir de `src`.
+Lista spt_path(ShortestPathTree t, Node dest);
+// Caminho src -> dest em O(tamanho do caminho). Lista vazia se inalcançável.
+double spt_cost(ShortestPathTree t, Node dest);
+// Custo src -> dest, ou DBL_MAX se inalcançável.
+Node spt_getSource(ShortestPathTree t);
+bool spt_isStale(ShortestPathTree t);
+// true se o grafo mudou (getGraphVersion) depois da construção.
+void spt_destroy(ShortestPathTree t);
+
+// Congela o grafo em um snapshot CSR (offsets + destinos + pesos contíguos).
+// Os pesos de todos os critérios são pré-calculados com `f`.
+// Qualquer addNode/addEdge posterior invalida o snapshot.
+void freezeGraph(Graph g, CalculaCustoAresta f);
+// Dijkstra sobre o snapshot CSR. Se o snapshot estiver desatualizado,
+// ele é reconstruído com a última função usada em freezeGraph.
+// Retorna lista vazia se o grafo nunca foi congelado.
+Lista findPathFrozen(Graph g, Node start, Node end, int crit);
+
+#define REORDENA_HILBERT 0
+#define REORDENA_BFS 1
+void reorderGraph(Graph g, int metodo);
+// Renumera internamente os nós (curva de Hilbert das coordenadas ou ordem
+// de BFS) para melhorar a localidade do snapshot. Os ids vistos pelo
+// chamador (getNode, findPath, findNearestNode...) não mudam.
+
 #endif
\ No newline at end of file
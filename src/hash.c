@@ -13,6 +13,8 @@ typedef struct HashNode {
 typedef struct {
     HashNode** buckets;
     int size;
+    int count;  // número de chaves (controla o fator de carga)
+    Arena arena; // != NULL: nós na arena e chaves emprestadas (sem cópia)
 } HashImpl;
 
 // Função de Hash simples (DJB2)
@@ -25,11 +27,39 @@ unsigned long hashFunction(const char* str) {
 
 hashTable createHashTable(int size) {
     HashImpl* ht = malloc(sizeof(HashImpl));
+    if (size < 1) size = 1;
     ht->buckets = calloc(size, sizeof(HashNode*));
     ht->size = size;
+    ht->count = 0;
+    ht->arena = NULL;
     return ht;
 }
 
+hashTable createHashTableArena(int size, Arena arena) {
+    HashImpl* ht = createHashTable(size);
+    ht->arena = arena;
+    return ht;
+}
+
+// Dobra o número de buckets e redistribui os nós existentes (sem realocar nós)
+static void hashRehash(HashImpl* h) {
+    int novoSize = 2*h->size + 1;
+    HashNode** novos = calloc(novoSize, sizeof(HashNode*));
+    for (int i = 0; i < h->size; i++) {
+        HashNode* node = h->buckets[i];
+        while (node) {
+            HashNode* prox = node->next;
+            unsigned long idx = hashFunction(node->key) % novoSize;
+            node->next = novos[idx];
+            novos[idx] = node;
+            node = prox;
+        }
+    }
+    free(h->buckets);
+    h->buckets = novos;
+    h->size = novoSize;
+}
+
 void hashPut(hashTable ht, const char* key, int value) {
     HashImpl* h = (HashImpl*)ht;
     unsigned long idx = hashFunction(key) % h->size;
@@ -44,11 +74,20 @@ void hashPut(hashTable ht, const char* key, int value) {
     }
     
     // Novo nó
-    HashNode* novo = malloc(sizeof(HashNode));
-    novo->key = duplicar_string(key);
+    HashNode* novo;
+    if (h->arena) {
+        novo = arena_aloca(h->arena, sizeof(HashNode));
+        novo->key = (char*)key;
+    } else {
+        novo = malloc(sizeof(HashNode));
+        novo->key = duplicar_string(key);
+    }
     novo->value = value;
     novo->next = h->buckets[idx];
     h->buckets[idx] = novo;
+    
+    // Fator de carga > 1: cresce para manter as cadeias curtas
+    if (++h->count > h->size) hashRehash(h);
 }
 
 bool hashGet(hashTable ht, const char* key, int* value) {
@@ -68,7 +107,7 @@ bool hashGet(hashTable ht, const char* key, int* value) {
 
 void hashTableDestroy(hashTable ht) {
     HashImpl* h = (HashImpl*)ht;
-    for(int i=0; i<h->size; i++) {
+    for(int i=0; i<h->size && !h->arena; i++) {
         HashNode* node = h->buckets[i];
         while(node) {
             HashNode* temp = node;
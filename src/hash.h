@@ -1,10 +1,17 @@
 #ifndef HASH_H
 #define HASH_H
 #include <stdbool.h>
+#include "arena.h"
 
 typedef void* hashTable;
 
+// `size` é apenas o tamanho inicial: a tabela cresce conforme recebe chaves
 hashTable createHashTable(int size);
+// Igual, mas os nós vêm de `arena` e as chaves não são copiadas: a tabela
+// guarda o próprio ponteiro, que deve viver tanto quanto a arena (ex.: uma
+// string já duplicada nela). Nada é liberado por hashTableDestroy além dos
+// baldes.
+hashTable createHashTableArena(int size, Arena arena);
 // Insere/parâmetro: associa `key` -> `value` na tabela
 void hashPut(hashTable ht, const char* key, int value);
 // Recupera o valor associado à `key`, retorna true se encontrado
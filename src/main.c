@@ -77,6 +77,7 @@ typedef struct {
     Node destino;       // Nó de chegada
     Camera2D cam;       // Câmera do Raylib
     float distanciaKm;  // Distância calculada da rota
+    ShortestPathTree spt; // Árvore de caminhos mínimos a partir da origem
 } AppState;
 
 // Struct interna das arestas (InfoV) para manipular pesos
@@ -92,23 +93,26 @@ typedef struct {
 
 // Recupera a posição (x,y) de um nó do grafo de forma segura
 Vector2 GetNodePos(Graph g, Node n) {
-    typedef struct { double x; double y; } C;
-    C* c = (C*)getNodeInfo(g, n);
-    if (!c) return (Vector2){0,0};
-    return (Vector2){(float)c->x, (float)c->y};
+    if (n < 0 || n >= getTotalNodes(g)) return (Vector2){0,0};
+    double x, y;
+    getNodeCoord(g, n, &x, &y);
+    return (Vector2){(float)x, (float)y};
 }
 
 // Busca a informação interna da aresta entre u e v
+// findEdge consulta o índice (u,v) do grafo: O(1), sem alocar Lista
 InfoV* GetInfoAresta(Graph g, int u, int v) {
-    Lista viz = lista_cria();
-    adjacentEdges(g, u, viz);
-    InfoV* targetInfo = NULL;
-    while(!lista_vazia(viz)) {
-        Edge e = lista_remove_primeiro(viz);
-        if (getToNode(g, e) == v) targetInfo = (InfoV*)getEdgeInfo(g, e);
-    }
-    lista_libera(viz);
-    return targetInfo;
+    Edge e = findEdge(g, u, v);
+    return e ? (InfoV*)getEdgeInfo(g, e) : NULL;
+}
+
+// Avisa o grafo que o InfoV da via u<->v mudou (as duas direções compartilham
+// o mesmo InfoV), para que os pesos em cache do Dijkstra sejam recalculados
+void NotificarVia(Graph g, int u, int v) {
+    Edge ida = findEdge(g, u, v);
+    Edge volta = findEdge(g, v, u);
+    if (ida) setEdgeAttr(g, ida, getEdgeInfo(g, ida));
+    if (volta) setEdgeAttr(g, volta, getEdgeInfo(g, volta));
 }
 
 // Adiciona um evento ao mapa e altera o peso da aresta no grafo
@@ -126,6 +130,7 @@ void AdicionarEvento(Graph g, int u, int v, TipoEvento t) {
                     infoIda->vel = 0.1; infoVolta->vel = 0.1; break;
                 default: break; 
             }
+            NotificarVia(g, u, v);
         }
     }
 }
@@ -179,8 +184,20 @@ void PenalizarRotaAtual(Graph g, Lista rotaAtual) {
         Node u = (Node)(intptr_t)lista_get_por_indice(rotaAtual, i);
         Node v = (Node)(intptr_t)lista_get_por_indice(rotaAtual, i+1);
         InfoV* info = GetInfoAresta(g, u, v);
-        if (info && info->vel > 1.0) info->vel *= 0.5;
+        if (info && info->vel > 1.0) { info->vel *= 0.5; NotificarVia(g, u, v); }
+    }
+}
+
+// Rota da origem até o destino atual. A árvore de caminhos mínimos da origem
+// é reaproveitada entre cliques e só é recalculada quando a origem muda ou o
+// grafo muda (eventos, penalização de rota).
+Lista RotaDaOrigem(AppState* app) {
+    if (app->spt && (spt_isStale(app->spt) || spt_getSource(app->spt) != app->origem)) {
+        spt_destroy(app->spt);
+        app->spt = NULL;
     }
+    if (!app->spt) app->spt = createSPT(app->g, app->origem, CRITERIO_TEMPO, CustoInteligente);
+    return spt_path(app->spt, app->destino);
 }
 
 // ============================================================
@@ -189,15 +206,16 @@ void PenalizarRotaAtual(Graph g, Lista rotaAtual) {
 void CriarCidade(Graph g, AppState* app) {
     int cols = 10; int rows = 8; float spacing = 100.0f;
     int nodeCount = 0;
+    Arena arena = getGraphArena(g); // Vias são liberadas junto com o grafo
     
     // 1. Grade Central
     for (int y = 0; y < rows; y++) {
         for (int x = 0; x < cols; x++) {
-            typedef struct { double x; double y; } C; C* c = malloc(sizeof(C));
-            c->x = (x * spacing) + 200 + GetRandomValue(-5, 5); 
-            c->y = (y * spacing) + 150 + GetRandomValue(-5, 5);
+            double px = (x * spacing) + 200 + GetRandomValue(-5, 5); 
+            double py = (y * spacing) + 150 + GetRandomValue(-5, 5);
             char nome[20]; sprintf(nome, "N%d", nodeCount++); 
-            addNode(g, nome, c);
+            Node id = addNode(g, nome, NULL);
+            setNodeCoord(g, id, px, py);
         }
     }
     // 2. Conexões Internas
@@ -206,31 +224,36 @@ void CriarCidade(Graph g, AppState* app) {
             int u = y * cols + x;
             if (x < cols - 1) { 
                 int v = u + 1; 
-                InfoV* i = malloc(sizeof(InfoV)); *i = (InfoV){"Rua",0,0, spacing, 60}; 
+                InfoV* i = arena_aloca(arena, sizeof(InfoV)); *i = (InfoV){"Rua",0,0, spacing, 60}; 
                 addEdge(g, u, v, i); addEdge(g, v, u, i); 
             }
             if (y < rows - 1) { 
                 int v = u + cols; 
-                InfoV* i = malloc(sizeof(InfoV)); *i = (InfoV){"Av",0,0, spacing, 60}; 
+                InfoV* i = arena_aloca(arena, sizeof(InfoV)); *i = (InfoV){"Av",0,0, spacing, 60}; 
                 addEdge(g, u, v, i); addEdge(g, v, u, i); 
             }
         }
     }
 
     // 3. Rodovias Externas (Conexões Rápidas)
-    typedef struct { double x; double y; } C; 
-    InfoV* iRod = malloc(sizeof(InfoV)); *iRod = (InfoV){"Rodovia",0,0, 400, 110};
+    // Cada rodovia tem seu próprio InfoV: penalizar uma não altera as outras
+    InfoV rodovia = (InfoV){"Rodovia",0,0, 400, 110};
+    InfoV* iRod;
 
-    int norte = addNode(g, "Norte", (C*)malloc(sizeof(C))); ((C*)getNodeInfo(g, norte))->x = 650; ((C*)getNodeInfo(g, norte))->y = -100;
+    int norte = addNode(g, "Norte", NULL); setNodeCoord(g, norte, 650, -100);
+    iRod = arena_aloca(arena, sizeof(InfoV)); *iRod = rodovia;
     addEdge(g, norte, 4, iRod); addEdge(g, 4, norte, iRod);
 
-    int sul = addNode(g, "Sul", (C*)malloc(sizeof(C))); ((C*)getNodeInfo(g, sul))->x = 650; ((C*)getNodeInfo(g, sul))->y = 1000;
+    int sul = addNode(g, "Sul", NULL); setNodeCoord(g, sul, 650, 1000);
+    iRod = arena_aloca(arena, sizeof(InfoV)); *iRod = rodovia;
     addEdge(g, sul, 74, iRod); addEdge(g, 74, sul, iRod);
 
-    int oeste = addNode(g, "Oeste", (C*)malloc(sizeof(C))); ((C*)getNodeInfo(g, oeste))->x = -150; ((C*)getNodeInfo(g, oeste))->y = 400;
+    int oeste = addNode(g, "Oeste", NULL); setNodeCoord(g, oeste, -150, 400);
+    iRod = arena_aloca(arena, sizeof(InfoV)); *iRod = rodovia;
     addEdge(g, oeste, 30, iRod); addEdge(g, 30, oeste, iRod);
 
-    int leste = addNode(g, "Leste", (C*)malloc(sizeof(C))); ((C*)getNodeInfo(g, leste))->x = 1450; ((C*)getNodeInfo(g, leste))->y = 400;
+    int leste = addNode(g, "Leste", NULL); setNodeCoord(g, leste, 1450, 400);
+    iRod = arena_aloca(arena, sizeof(InfoV)); *iRod = rodovia;
     addEdge(g, leste, 39, iRod); addEdge(g, 39, leste, iRod);
 
     // 4. Inserção de Eventos (Desafios para o Dijkstra)
@@ -327,7 +350,7 @@ int main(int argc, char* argv[]) {
 
     // 2. Inicializar Grafo
     AppState app = {0};
-    app.g = createGraph(300, true, "Cidade");
+    app.g = createGraph(0, true, "Cidade"); // Capacidade cresce sob demanda
     CriarCidade(app.g, &app);
 
     // Configurações Iniciais
@@ -340,7 +363,7 @@ int main(int argc, char* argv[]) {
     app.cam.target = (Vector2){700, 500};
     
     // Rota inicial
-    app.rota = findPath(app.g, app.origem, app.destino, CRITERIO_TEMPO, CustoInteligente);
+    app.rota = RotaDaOrigem(&app);
     app.distanciaKm = CalcularDistanciaRota(app.g, app.rota);
 
     // Botões 
@@ -384,7 +407,7 @@ int main(int argc, char* argv[]) {
                     if (n != -1) {
                         app.destino = n;
                         if (app.rota) lista_libera(app.rota);
-                        app.rota = findPath(app.g, app.origem, app.destino, CRITERIO_TEMPO, CustoInteligente);
+                        app.rota = RotaDaOrigem(&app); // Mesma origem: só sobe pela árvore
                         app.distanciaKm = CalcularDistanciaRota(app.g, app.rota);
                     }
                 }
@@ -412,7 +435,7 @@ int main(int argc, char* argv[]) {
             if (!app.navegando && !app.chegou && app.rota) {
                 PenalizarRotaAtual(app.g, app.rota);
                 lista_libera(app.rota);
-                app.rota = findPath(app.g, app.origem, app.destino, CRITERIO_TEMPO, CustoInteligente);
+                app.rota = RotaDaOrigem(&app); // Penalização mudou o grafo: árvore é refeita
                 app.distanciaKm = CalcularDistanciaRota(app.g, app.rota);
             }
         }
@@ -480,6 +503,9 @@ int main(int argc, char* argv[]) {
     }
     
     UnloadTexture(assets.car_icon); UnloadTexture(assets.flag_icon);
+    if (app.rota) lista_libera(app.rota);
+    if (app.spt) spt_destroy(app.spt);
+    destroyGraph(app.g);
     CloseWindow();
     return 0;
 }
\ No newline at end of file
@@ -1,22 +1,66 @@
 // priority_queue.c
 #include "priority_queue.h"
 #include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <float.h>
+
+#define PQ_BINARIO 0   // Heap binário com itens repetidos (reinserção preguiçosa)
+#define PQ_INDEXADO 1  // Heap d-ário com mapa de posições e decrease-key
+#define PQ_RADIX 2     // Radix heap monótono (chaves = bits do double)
+#define PQ_BALDES 3    // Fila de baldes de Dial (monótona, largura fixa)
+
+#define RADIX_BALDES 65  // Balde 0 (igual ao último extraído) + 1 por bit
 
-// Implementação via Binary Heap (Min-Heap)
 typedef struct { int id; double p; } HeapNode;
-typedef struct { HeapNode* data; int size; int cap; } PQImpl;
+typedef struct { HeapNode* itens; int n, cap; } Balde;
+typedef struct {
+    int tipo;
+    HeapNode* data;  // Binário: data[1..size]; indexado: data[0..size-1]
+    void* bruto;     // Bloco alocado (no indexado, data é deslocado para alinhar)
+    int size;
+    int cap;
+    int d;           // Aridade do heap indexado
+    int* pos;        // pos[item] = índice em data, -1 se fora da fila
+    int nItens;      // Tamanho de pos
+    // Radix e baldes: itens repetidos, como no binário
+    Balde* baldes;
+    int nBaldes;
+    uint64_t ultimo; // Radix: chave do último extraído
+    double largura;  // Baldes: faixa de prioridade coberta por cada balde
+    long long base;  // Baldes: número absoluto do balde corrente
+} PQImpl;
+
+static void baldeInsere(Balde* b, HeapNode no) {
+    if (b->n == b->cap) {
+        b->cap = b->cap ? 2*b->cap : 4;
+        b->itens = realloc(b->itens, b->cap * sizeof(HeapNode));
+    }
+    b->itens[b->n++] = no;
+}
 
+// ============================================================================
+// HEAP BINÁRIO (Min-Heap)
+// ============================================================================
 priorityQueue createPriorityQueue(int cap) {
-    PQImpl* pq = malloc(sizeof(PQImpl));
+    PQImpl* pq = calloc(1, sizeof(PQImpl));
+    if (cap < 1) cap = 1;
+    pq->tipo = PQ_BINARIO;
     pq->data = malloc((cap+1) * sizeof(HeapNode));
+    pq->bruto = pq->data;
     pq->size = 0;
     pq->cap = cap;
     return pq;
 }
 
 // Insere mantendo a propriedade do Heap (Sobe o elemento)
-void pq_insert(priorityQueue pq, int item, double prio) {
-    PQImpl* p = (PQImpl*)pq;
+static void binarioInsere(PQImpl* p, int item, double prio) {
+    if (p->size == p->cap) {
+        // Cheio: dobra em vez de escrever além de data[cap]
+        p->cap *= 2;
+        p->data = realloc(p->data, (p->cap+1) * sizeof(HeapNode));
+        p->bruto = p->data;
+    }
     int i = ++p->size;
     while (i > 1 && p->data[i/2].p > prio) {
         p->data[i] = p->data[i/2];
@@ -27,8 +71,7 @@ void pq_insert(priorityQueue pq, int item, double prio) {
 }
 
 // Remove o menor elemento (raiz) e reorganiza (Desce o elemento)
-int pq_extract_min(priorityQueue pq) {
-    PQImpl* p = (PQImpl*)pq;
+static int binarioExtrai(PQImpl* p) {
     if (p->size == 0) return -1;
     int minItem = p->data[1].id;
     HeapNode last = p->data[p->size--];
@@ -44,5 +87,304 @@ int pq_extract_min(priorityQueue pq) {
     return minItem;
 }
 
+// ============================================================================
+// HEAP D-ÁRIO INDEXADO
+// ============================================================================
+// Raiz em data[0]; filhos de i em [d*i+1, d*i+d]. Árvore mais rasa que a
+// binária (log_d n níveis), e com d = 4 e nós de 16 bytes cada grupo de
+// irmãos ocupa exatamente uma linha de cache de 64 bytes, pois data[1] é
+// alinhado em 64. pos[] permite achar um item em O(1) para decrease-key.
+// ============================================================================
+static HeapNode* alocaAlinhado(int cap, void** bruto) {
+    char* b = malloc((size_t)(cap + 1) * sizeof(HeapNode) + 64);
+    uintptr_t a = ((uintptr_t)(b + sizeof(HeapNode)) + 63) & ~(uintptr_t)63;
+    *bruto = b;
+    return (HeapNode*)a - 1;
+}
+
+priorityQueue createIndexedPriorityQueue(int nItens, int aridade) {
+    PQImpl* pq = calloc(1, sizeof(PQImpl));
+    if (nItens < 1) nItens = 1;
+    pq->tipo = PQ_INDEXADO;
+    pq->d = aridade > 1 ? aridade : PQ_ARIDADE_PADRAO;
+    pq->cap = nItens;
+    pq->data = alocaAlinhado(pq->cap, &pq->bruto);
+    pq->nItens = nItens;
+    pq->pos = malloc(nItens * sizeof(int));
+    memset(pq->pos, -1, nItens * sizeof(int));
+    return pq;
+}
+
+static void indexadoSobe(PQImpl* p, int i, HeapNode no) {
+    while (i > 0) {
+        int pai = (i - 1) / p->d;
+        if (p->data[pai].p <= no.p) break;
+        p->data[i] = p->data[pai];
+        p->pos[p->data[i].id] = i;
+        i = pai;
+    }
+    p->data[i] = no;
+    p->pos[no.id] = i;
+}
+
+static void indexadoDesce(PQImpl* p, int i, HeapNode no) {
+    while (true) {
+        int prim = p->d * i + 1;
+        if (prim >= p->size) break;
+        int fim = prim + p->d < p->size ? prim + p->d : p->size;
+        int menor = prim;
+        for (int c = prim + 1; c < fim; c++)
+            if (p->data[c].p < p->data[menor].p) menor = c;
+        if (p->data[menor].p >= no.p) break;
+        p->data[i] = p->data[menor];
+        p->pos[p->data[i].id] = i;
+        i = menor;
+    }
+    p->data[i] = no;
+    p->pos[no.id] = i;
+}
+
+static void indexadoInsere(PQImpl* p, int item, double prio) {
+    if (item >= p->nItens) {
+        int n = p->nItens;
+        while (n <= item) n *= 2;
+        p->pos = realloc(p->pos, n * sizeof(int));
+        memset(p->pos + p->nItens, -1, (n - p->nItens) * sizeof(int));
+        p->nItens = n;
+    }
+    int i = p->pos[item];
+    if (i != -1) {
+        // Já está na fila: só diminui a prioridade
+        if (prio < p->data[i].p) indexadoSobe(p, i, (HeapNode){item, prio});
+        return;
+    }
+    if (p->size == p->cap) {
+        void* bruto;
+        HeapNode* novo = alocaAlinhado(2 * p->cap, &bruto);
+        memcpy(novo, p->data, p->size * sizeof(HeapNode));
+        free(p->bruto);
+        p->data = novo;
+        p->bruto = bruto;
+        p->cap *= 2;
+    }
+    indexadoSobe(p, p->size++, (HeapNode){item, prio});
+}
+
+static int indexadoExtrai(PQImpl* p) {
+    if (p->size == 0) return -1;
+    int minItem = p->data[0].id;
+    p->pos[minItem] = -1;
+    HeapNode last = p->data[--p->size];
+    if (p->size > 0) indexadoDesce(p, 0, last);
+    return minItem;
+}
+
+// ============================================================================
+// RADIX HEAP
+// ============================================================================
+// Para double >= 0 a ordem dos padrões de bits (como uint64) é a mesma dos
+// valores, então não é preciso quantizar. Um item com chave k fica no balde
+// do bit mais alto em que k difere de `ultimo` (balde 0 se igual). Como a
+// fila é monótona (nenhuma chave menor que `ultimo` entra depois), ao
+// esvaziar o balde 0 basta achar o menor do primeiro balde não vazio e
+// redistribuí-lo: cada item desce de balde no máximo 64 vezes.
+// ============================================================================
+static uint64_t chaveRadix(double prio) {
+    if (!(prio > 0)) return 0;  // 0, -0 e negativos (fora do contrato)
+    uint64_t k;
+    memcpy(&k, &prio, sizeof k);
+    return k;
+}
+
+static int baldeRadix(uint64_t k, uint64_t ultimo) {
+    uint64_t x = k ^ ultimo;
+    if (!x) return 0;
+#if defined(__GNUC__)
+    return 64 - __builtin_clzll(x);
+#else
+    int b = 0;
+    while (x) { b++; x >>= 1; }
+    return b;
+#endif
+}
+
+priorityQueue createRadixHeap(void) {
+    PQImpl* pq = calloc(1, sizeof(PQImpl));
+    pq->tipo = PQ_RADIX;
+    pq->nBaldes = RADIX_BALDES;
+    pq->baldes = calloc(RADIX_BALDES, sizeof(Balde));
+    return pq;
+}
+
+static void radixInsere(PQImpl* p, int item, double prio) {
+    uint64_t k = chaveRadix(prio);
+    if (k < p->ultimo) {
+        // Arredondamento abaixo do último extraído: trata como igual
+        k = p->ultimo;
+        memcpy(&prio, &k, sizeof prio);
+    }
+    baldeInsere(&p->baldes[baldeRadix(k, p->ultimo)], (HeapNode){item, prio});
+    p->size++;
+}
+
+// Garante que o balde 0 tem os itens de menor chave
+static void radixPrepara(PQImpl* p) {
+    if (p->size == 0 || p->baldes[0].n > 0) return;
+    int i = 1;
+    while (p->baldes[i].n == 0) i++;
+    Balde* b = &p->baldes[i];
+    uint64_t menor = chaveRadix(b->itens[0].p);
+    for (int j = 1; j < b->n; j++) {
+        uint64_t k = chaveRadix(b->itens[j].p);
+        if (k < menor) menor = k;
+    }
+    p->ultimo = menor;
+    // Todos os itens de b diferem de `menor` num bit abaixo de i: descem
+    for (int j = 0; j < b->n; j++)
+        baldeInsere(&p->baldes[baldeRadix(chaveRadix(b->itens[j].p), menor)], b->itens[j]);
+    b->n = 0;
+}
+
+static int radixExtrai(PQImpl* p) {
+    if (p->size == 0) return -1;
+    radixPrepara(p);
+    p->size--;
+    return p->baldes[0].itens[--p->baldes[0].n].id;
+}
+
+// ============================================================================
+// FILA DE BALDES (DIAL)
+// ============================================================================
+// O balde absoluto de uma prioridade é floor(prio / largura); os baldes são
+// um vetor circular de nBaldes posições a partir de `base`. Dentro de um
+// balde a ordem é arbitrária, por isso a fila só é exata para Dijkstra se a
+// largura for <= menor peso de aresta: um nó retirado do balde corrente não
+// pode melhorar outro nó do mesmo balde. Também é monótona: prioridades
+// abaixo do balde corrente entram nele.
+// ============================================================================
+priorityQueue createBucketQueue(double largura, int nBaldes) {
+    PQImpl* pq = calloc(1, sizeof(PQImpl));
+    pq->tipo = PQ_BALDES;
+    pq->largura = largura > 0 ? largura : 1;
+    pq->nBaldes = nBaldes > 1 ? nBaldes : 2;
+    pq->baldes = calloc(pq->nBaldes, sizeof(Balde));
+    return pq;
+}
+
+static void baldesInsere(PQImpl* p, int item, double prio) {
+    long long k = (long long)(prio / p->largura);
+    if (k < p->base) k = p->base;
+    if (k - p->base >= p->nBaldes) {
+        // Fora da janela circular: dobra o número de baldes e redistribui
+        int velho = p->nBaldes;
+        Balde* antigos = p->baldes;
+        int novo = velho;
+        while (k - p->base >= novo) novo *= 2;
+        p->baldes = calloc(novo, sizeof(Balde));
+        p->nBaldes = novo;
+        for (int i = 0; i < velho; i++) {
+            for (int j = 0; j < antigos[i].n; j++) {
+                HeapNode no = antigos[i].itens[j];
+                long long kj = (long long)(no.p / p->largura);
+                if (kj < p->base) kj = p->base;
+                baldeInsere(&p->baldes[kj % novo], no);
+            }
+            free(antigos[i].itens);
+        }
+        free(antigos);
+    }
+    baldeInsere(&p->baldes[k % p->nBaldes], (HeapNode){item, prio});
+    p->size++;
+}
+
+// Avança `base` até um balde não vazio
+static Balde* baldeCorrente(PQImpl* p) {
+    while (p->baldes[p->base % p->nBaldes].n == 0) p->base++;
+    return &p->baldes[p->base % p->nBaldes];
+}
+
+static int baldesExtrai(PQImpl* p) {
+    if (p->size == 0) return -1;
+    Balde* b = baldeCorrente(p);
+    p->size--;
+    return b->itens[--b->n].id;
+}
+
+// ============================================================================
+// INTERFACE
+// ============================================================================
+void pq_insert(priorityQueue pq, int item, double prio) {
+    PQImpl* p = (PQImpl*)pq;
+    switch (p->tipo) {
+        case PQ_INDEXADO: indexadoInsere(p, item, prio); break;
+        case PQ_RADIX: radixInsere(p, item, prio); break;
+        case PQ_BALDES: baldesInsere(p, item, prio); break;
+        default: binarioInsere(p, item, prio);
+    }
+}
+
+int pq_extract_min(priorityQueue pq) {
+    PQImpl* p = (PQImpl*)pq;
+    switch (p->tipo) {
+        case PQ_INDEXADO: return indexadoExtrai(p);
+        case PQ_RADIX: return radixExtrai(p);
+        case PQ_BALDES: return baldesExtrai(p);
+        default: return binarioExtrai(p);
+    }
+}
+
+void pq_decrease_key(priorityQueue pq, int item, double prio) {
+    // Indexado: pq_insert já atualiza o item presente.
+    // Demais: insere uma cópia e a entrada antiga fica velha.
+    pq_insert(pq, item, prio);
+}
+
+bool pq_contains(priorityQueue pq, int item) {
+    PQImpl* p = (PQImpl*)pq;
+    if (p->tipo == PQ_INDEXADO) return item >= 0 && item < p->nItens && p->pos[item] != -1;
+    if (p->tipo == PQ_BINARIO) {
+        for (int i = 1; i <= p->size; i++) if (p->data[i].id == item) return true;
+        return false;
+    }
+    for (int b = 0; b < p->nBaldes; b++)
+        for (int j = 0; j < p->baldes[b].n; j++) if (p->baldes[b].itens[j].id == item) return true;
+    return false;
+}
+
 bool pq_empty(priorityQueue pq) { return ((PQImpl*)pq)->size == 0; }
-void pq_destroy(priorityQueue pq) { free(((PQImpl*)pq)->data); free(pq); }
\ No newline at end of file
+double pq_min_prio(priorityQueue pq) {
+    PQImpl* p = (PQImpl*)pq;
+    if (!p->size) return DBL_MAX;
+    switch (p->tipo) {
+        case PQ_INDEXADO: return p->data[0].p;
+        case PQ_RADIX: radixPrepara(p); return p->baldes[0].itens[p->baldes[0].n - 1].p;
+        case PQ_BALDES: { Balde* b = baldeCorrente(p); return b->itens[b->n - 1].p; }
+        default: return p->data[1].p;
+    }
+}
+void pq_clear(priorityQueue pq) {
+    PQImpl* p = (PQImpl*)pq;
+    if (p->tipo == PQ_INDEXADO)
+        for (int i = 0; i < p->size; i++) p->pos[p->data[i].id] = -1;
+    if (p->tipo == PQ_RADIX) {
+        for (int b = 0; b < p->nBaldes; b++) p->baldes[b].n = 0;
+        p->ultimo = 0;
+    }
+    if (p->tipo == PQ_BALDES) {
+        // Os itens estão na janela a partir de `base`: para ao zerar `size`
+        for (long long k = p->base; p->size > 0; k++) {
+            p->size -= p->baldes[k % p->nBaldes].n;
+            p->baldes[k % p->nBaldes].n = 0;
+        }
+        p->base = 0;
+    }
+    p->size = 0;
+}
+void pq_destroy(priorityQueue pq) {
+    PQImpl* p = (PQImpl*)pq;
+    for (int b = 0; b < p->nBaldes; b++) free(p->baldes[b].itens);
+    free(p->baldes);
+    free(p->bruto);
+    free(p->pos);
+    free(p);
+}
@@ -4,11 +4,35 @@
 
 typedef void* priorityQueue;
 priorityQueue createPriorityQueue(int cap);
+// Heap binário; o mesmo item pode entrar várias vezes (reinserção
+// preguiçosa). `cap` é só a capacidade inicial: a fila cresce sob demanda.
+#define PQ_ARIDADE_PADRAO 4
+priorityQueue createIndexedPriorityQueue(int nItens, int aridade);
+// Heap d-ário indexado para itens 0..nItens-1 (cresce se vier item maior).
+// Cada item aparece no máximo uma vez: inserir um item presente só diminui
+// sua prioridade. `aridade` <= 1 usa PQ_ARIDADE_PADRAO.
+priorityQueue createRadixHeap(void);
+// Radix heap monótono para prioridades >= 0: nenhuma prioridade inserida
+// pode ser menor que a do último item extraído (vale para Dijkstra).
+priorityQueue createBucketQueue(double largura, int nBaldes);
+// Fila de baldes de Dial: cada balde cobre `largura` de prioridade, em
+// `nBaldes` posições circulares (cresce se preciso). Monótona, e dentro de
+// um balde a ordem é arbitrária: para Dijkstra exato use largura <= menor
+// peso de aresta e nBaldes > maior peso / largura.
 // Insere item com prioridade `prio`.
 void pq_insert(priorityQueue pq, int item, double prio);
 // Extrai o item de menor prioridade (menor `prio`). Retorna -1 se vazio.
 int pq_extract_min(priorityQueue pq);
+// Diminui a prioridade de `item` (insere se ausente). No heap indexado é
+// O(log n) no lugar; nas outras filas vira uma nova inserção.
+void pq_decrease_key(priorityQueue pq, int item, double prio);
+// O item está na fila? O(1) no heap indexado, busca linear nas outras.
+bool pq_contains(priorityQueue pq, int item);
 bool pq_empty(priorityQueue pq);
+// Prioridade do menor item sem removê-lo (DBL_MAX se vazio).
+double pq_min_prio(priorityQueue pq);
+// Esvazia a fila mantendo a memória para reuso.
+void pq_clear(priorityQueue pq);
 void pq_destroy(priorityQueue pq);
 
 #endif
\ No newline at end of file
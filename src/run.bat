@@ -4,7 +4,7 @@ echo Configurando ambiente Raylib...
 set PATH=C:\raylib\w64devkit\bin;%PATH%
 
 echo Compilando projeto...
-gcc main.c graph.c via.c lista.c priority_queue.c utils.c geo.c svg.c qry.c hash.c smutreap.c fila.c -o waze_app.exe -O1 -Wall -std=c99 -Wno-missing-braces -I. -L. -lraylib -lopengl32 -lgdi32 -lwinmm
+gcc main.c graph.c via.c lista.c priority_queue.c utils.c geo.c svg.c qry.c hash.c arena.c ch.c alt.c smutreap.c fila.c -o waze_app.exe -O1 -Wall -std=c99 -Wno-missing-braces -I. -L. -lraylib -lopengl32 -lgdi32 -lwinmm -lpthread
 
 if %errorlevel% neq 0 (
     echo [ERRO] Falha na compilacao.
@@ -4,7 +4,6 @@
 #include <stdlib.h>
 #include <string.h>
 
-typedef struct { double x, y; } Coord;
 typedef struct { char *n, *cd, *ce; double len, vel; } InfoVia;
 
 double calculaCustoAresta(Info info, int crit) {
@@ -17,17 +16,19 @@ Graph carregarGrafoDeArquivoVia(const char* path) {
     FILE* f = fopen(path, "r");
     if (!f) return NULL;
     
-    int n;
-    fscanf(f, "%d", &n);
+    // O total no cabeçalho é só uma dica de capacidade: o grafo cresce se preciso
+    int n = 0;
+    if (fscanf(f, "%d", &n) != 1) n = 0;
     Graph g = createGraph(n, true, "Londrina");
+    Arena arena = getGraphArena(g); // Infos vivem junto com o grafo
     
     char type[10];
     while(fscanf(f, "%s", type) != EOF) {
         if (strcmp(type, "v") == 0) {
             char nome[50]; double x, y;
             fscanf(f, "%s %lf %lf", nome, &x, &y);
-            Coord* c = malloc(sizeof(Coord)); c->x=x; c->y=y;
-            addNode(g, nome, c);
+            Node id = addNode(g, nome, NULL);
+            setNodeCoord(g, id, x, y);
         } else if (strcmp(type, "e") == 0) {
             char u[50], v[50], l[50], r[50], rua[100]; double len, vel;
             fscanf(f, "%s %s %s %s %lf %lf", u, v, l, r, &len, &vel);
@@ -36,10 +37,21 @@ Graph carregarGrafoDeArquivoVia(const char* path) {
             int idU = getNode(g, u);
             int idV = getNode(g, v);
             if (idU != -1 && idV != -1) {
-                InfoVia* iv = malloc(sizeof(InfoVia));
-                iv->len = len; iv->vel = vel; iv->n = duplicar_string(rua);
+                InfoVia* iv = arena_aloca(arena, sizeof(InfoVia));
+                iv->len = len; iv->vel = vel; iv->n = arena_duplica_string(arena, rua);
+                iv->cd = iv->ce = NULL;
                 addEdge(g, idU, idV, iv);
             }
+        } else if (strcmp(type, "t") == 0) {
+            // Conversão: t <u> <v> <w> <custo> vale para u -> v -> w, depois
+            // das vias "e" envolvidas; custo negativo proíbe a conversão
+            char u[50], v[50], w[50]; double custo;
+            if (fscanf(f, "%s %s %s %lf", u, v, w, &custo) != 4) continue;
+            int idU = getNode(g, u), idV = getNode(g, v), idW = getNode(g, w);
+            if (idU != -1 && idV != -1 && idW != -1) {
+                Edge de = findEdge(g, idU, idV), para = findEdge(g, idV, idW);
+                if (de && para) setTurnCost(g, de, para, custo < 0 ? CONVERSAO_PROIBIDA : custo);
+            }
         }
     }
     fclose(f);